@@ -11,16 +11,19 @@
 #include "AI.h"
 #include <cstdlib>
 #include <ctime>
+#include <thread>
+#include <QCoreApplication>
 #include <QList>
 #include <QVector>
 #include <QDebug>
-#include <tuple> // for std::tuple and std::get
 
 /**
  * @brief Constructs the AI player using a vector of pieces.
  * 
  * Initializes the base Player class with a name and list of pieces. Also seeds the random generator
- * and initializes the minimax algorithm based on the difficulty.
+ * and initializes the minimax algorithm based on the difficulty. Hard is only limited by its
+ * time budget, which the search enforces internally, and uses the neural network evaluation
+ * when a weights file is found.
  * 
  * @param aiDifficulty The difficulty level of the AI (1 = easy, 2 = medium, 3 = hard).
  * @param aiPieces The vector of Piece pointers that belong to the AI.
@@ -28,9 +31,36 @@
 AI::AI(int aiDifficulty, std::vector<Piece*> aiPieces) 
     : Player("AI", QList<Piece*>(aiPieces.begin(), aiPieces.end())),
       difficulty(aiDifficulty),
-      minimaxAlgo(aiDifficulty * 2)
+      minimaxAlgo(aiDifficulty >= 3 ? MiniMaxAlgo::MAX_SEARCH_DEPTH : aiDifficulty * 2)
 {
     std::srand(std::time(nullptr));
+
+    // Hard searches on every core; the threads share one transposition table
+    if (difficulty >= 3)
+        minimaxAlgo.setThreads(static_cast<int>(std::thread::hardware_concurrency()));
+
+    // Endgame tables built by tools/tbgen, if they were copied next to the executable
+    if (usesSearch()) {
+        QString directory = QCoreApplication::applicationDirPath() + "/tablebases";
+        int tables = minimaxAlgo.loadTablebases(directory.toStdString());
+        if (tables > 0) {
+            qDebug() << "AI: loaded" << tables << "endgame tables, complete up to"
+                     << minimaxAlgo.endgameTables().maxPieces() << "pieces";
+        }
+
+        // Opening book built by tools/bookgen
+        QString bookPath = QCoreApplication::applicationDirPath() + "/book.ckb";
+        if (book.open(bookPath.toStdString())) {
+            qDebug() << "AI: opening book with" << book.size() << "moves";
+        }
+
+        // Hard evaluates with the neural network when its weights were copied there too
+        QString networkPath = QCoreApplication::applicationDirPath() + "/nnue.bin";
+        if (difficulty >= 3 && minimaxAlgo.loadNetwork(networkPath.toStdString())) {
+            minimaxAlgo.setEvaluator(Evaluator::Network);
+            qDebug() << "AI: network evaluation (" << NnueNetwork::simdName() << ")";
+        }
+    }
 }
 
 /**
@@ -57,69 +87,162 @@ AI::AI(int aiDifficulty, QList<Piece*> aiPieces)
 std::pair<Piece*, std::pair<int, int>> AI::getBestMove(CheckersBoard& board) {
     
     // Difficulty 1 = Easy mode: use random move
-    if (difficulty == 1) {
+    if (!usesSearch()) {
         return getRandomMove(board);  // Calls helper function to pick a random valid move
-    } 
-    // Difficulty 2 = Medium mode: use minimax with 200ms time limit
-    else if (difficulty == 2) {
-        std::tuple<int, int, int> move = minimaxAlgo.getBestTimedMove(board, 200);  // Run minimax for 200ms
-        
-        int pieceId = std::get<0>(move);       // Extract ID of selected piece
-        int targetRow = std::get<1>(move);     // Extract target row
-        int targetCol = std::get<2>(move);     // Extract target column
-        
-        Piece* bestPiece = board.getPieceById(pieceId);  // Get the actual piece from its ID
-        return { bestPiece, { targetRow, targetCol } };  // Return the move as a pair
-    } 
-    // Difficulty 3 or higher = Hard mode: use minimax with 350ms
-    else {
-        std::tuple<int, int, int> move = minimaxAlgo.getBestTimedMove(board, 350);
-
-        int pieceId = std::get<0>(move);       // Extract ID of selected piece
-        int targetRow = std::get<1>(move);     // Extract target row
-        int targetCol = std::get<2>(move);     // Extract target column
-        
-        Piece* bestPiece = board.getPieceById(pieceId);  // Get the actual piece using its ID
-        return { bestPiece, { targetRow, targetCol } };  // Return the selected move
     }
+
+    // Difficulty 2 = Medium (200ms) and 3 = Hard (350ms): use minimax
+    Position pos = board.getPosition(PieceColor::Red);    // Snapshot the board once at the root
+    MoveList rootMoves;
+    board.getLegalMoves(PieceColor::Red, rootMoves);      // Includes the rest of a capture chain
+    Move move = searchBestMove(pos, rootMoves, stopToken());
+
+    return toBoardMove(board, move);  // Map the move back onto the board's pieces
+}
+
+/**
+ * @brief Returns true if this difficulty runs the minimax search (Medium and Hard).
+ */
+bool AI::usesSearch() const {
+    return difficulty >= 2;
+}
+
+/**
+ * @brief Returns the time budget of one search: 200 ms on Medium, 350 ms on Hard.
+ */
+int AI::searchTimeMillis() const {
+    return (difficulty == 2) ? 200 : 350;
+}
+
+/**
+ * @brief Runs the timed minimax search on a board snapshot.
+ * 
+ * Plays straight from the opening book when the position is in it. Touches
+ * no Qt objects, so it may run on a worker thread while the board keeps
+ * changing on the GUI thread.
+ * 
+ * @param pos Snapshot of the board with Red to move.
+ * @param rootMoves Red's legal moves in that snapshot.
+ * @param token stopToken() read when the search was requested.
+ * @return The chosen move, or a null Move if there is none.
+ */
+Move AI::searchBestMove(const Position& pos, const MoveList& rootMoves, unsigned token) {
+    // The first search after pondering tells whether the user played the expected reply
+    if (pondered) {
+        if (pos.hash() == ponderKey) {
+            ponderHits++;
+        } else {
+            ponderMisses++;
+        }
+        pondered = false;
+        qDebug() << "AI: ponder" << (pos.hash() == ponderKey ? "hit" : "miss")
+                 << "(" << ponderHits << "hits," << ponderMisses << "misses )";
+    }
+
+    // Known openings are played straight from the book, saving the time budget for later
+    Move bookMove = book.probe(pos, rootMoves, static_cast<unsigned>(std::rand()));
+    if (!bookMove.isNull()) {
+        return bookMove;
+    }
+
+    Move move = minimaxAlgo.getBestTimedMove(pos, rootMoves, searchTimeMillis(), token);
+
+    const SearchStats& stats = minimaxAlgo.lastSearchStats();
+    if (stats.depth > 0) {
+        qDebug() << "AI: depth" << stats.depth << "seldepth" << stats.seldepth << "score" << stats.score
+                 << "nodes" << stats.nodes + stats.qnodes << "nps" << qRound64(stats.nodesPerSecond())
+                 << "tt hit rate" << stats.ttHitRate() << "first-move cutoff rate" << stats.firstMoveCutoffRate();
+    }
+
+    if (minimaxAlgo.lastSearchStats().tbHits > 0) {
+        TBProbeStats tb = minimaxAlgo.tablebaseStats();
+        qDebug() << "AI: tablebase hits" << minimaxAlgo.lastSearchStats().tbHits << "this move,"
+                 << tb.hits << "of" << tb.probes << "probes in total, block cache miss rate"
+                 << tb.missRate();
+    }
+    return move;
+}
+
+/**
+ * @brief Searches the user's position on the user's time.
+ * 
+ * Runs until stopSearch() is called. Everything it finds stays in the
+ * transposition table, so the next searchBestMove() starts warm and, after a
+ * ponder hit, reaches a deeper depth in the same time.
+ * 
+ * @param pos Snapshot of the board with Black (the user) to move.
+ * @param token stopToken() read when pondering was requested.
+ */
+void AI::ponder(const Position& pos, unsigned token) {
+    Move predicted = minimaxAlgo.ponder(pos, token);
+    if (predicted.isNull()) {
+        return;
+    }
+
+    // Remember the position the expected reply leads to
+    Position expected = pos;
+    expected.applyMove(predicted);
+    ponderKey = expected.hash();
+    pondered = true;
+}
+
+/**
+ * @brief Passes the per-iteration report function on to the search.
+ */
+void AI::setSearchInfoCallback(std::function<void(const SearchInfo&)> callback) {
+    minimaxAlgo.setInfoCallback(std::move(callback));
+}
+
+/**
+ * @brief Asks a running search to return as soon as possible. Safe from any thread.
+ */
+void AI::stopSearch() {
+    minimaxAlgo.stop();
+}
+
+/**
+ * @brief Returns the token a search must be started with for stopSearch() to cancel it.
+ */
+unsigned AI::stopToken() const {
+    return minimaxAlgo.stopToken();
+}
+
+/**
+ * @brief Maps a search Move onto the board's pieces.
+ * 
+ * @param board The board the move was searched on.
+ * @param move The move chosen by the search.
+ * @return A pair; the Piece to move and its first landing square (row, col),
+ *         or {nullptr, {-1, -1}} for a null move.
+ */
+std::pair<Piece*, std::pair<int, int>> AI::toBoardMove(CheckersBoard& board, const Move& move) {
+    if (move.isNull()) {
+        return {nullptr, {-1, -1}};
+    }
+
+    Piece* piece = board.getPieceAt(rowOf(move.from), colOf(move.from));  // Piece on the start square
+    int landing = move.firstLanding();                                     // First hop of the sequence
+    return { piece, { rowOf(landing), colOf(landing) } };
 }
 
 /**
  * @brief Makes a random valid move for the AI.
  * 
- * Iterates over all AI-controlled pieces and collects valid moves, then randomly selects one.
+ * Asks the board for every legal AI move and randomly selects one.
  * If no valid move is found, returns a null pointer and invalid coordinates.
  * 
  * @param board The current state of the checkers board.
  * @return A pair; the randomly selected Piece and its move position (row, col).
  */
 std::pair<Piece*, std::pair<int, int>> AI::getRandomMove(CheckersBoard& board) {
-    std::vector<std::pair<Piece*, std::pair<int, int>>> possibleMoves;
-    
-    // Get the updated list of AI pieces from the board
-    QList<Piece*> currentPieces = board.getAIPieces();
-
-    for (Piece* piece : currentPieces) {
-        if (!piece) continue;
-
-        // Get fresh pointer to the piece by ID
-        Piece* currentPiece = board.getPieceById(piece->getId());
-        if (!currentPiece) continue;
-
-        // Check every position on the board for valid moves
-        for (int row = 0; row < 8; row++) {
-            for (int col = 0; col < 8; col++) {
-                if (board.isValidMove(currentPiece, row, col)) {
-                    possibleMoves.push_back({currentPiece, {row, col}});
-                }
-            }
-        }
-    }
+    // Legal moves already enforce mandatory capture and capture chains
+    MoveList possibleMoves;
+    board.getLegalMoves(PieceColor::Red, possibleMoves);
 
     if (!possibleMoves.empty()) {
-        return possibleMoves[rand() % possibleMoves.size()];
+        return toBoardMove(board, possibleMoves[rand() % possibleMoves.size()]);
     }
 
     // No valid move found
     return {nullptr, {-1, -1}};
-}
\ No newline at end of file
+}
@@ -13,6 +13,7 @@
 
 #include "Player.h"
 #include "MiniMaxAlgo.h"
+#include "OpeningBook.h"
 
 /**
  * @class AI
@@ -26,6 +27,12 @@ class AI : public Player {
 private:
     int difficulty;           ///< The difficulty level of the AI (1 = Easy, 2 = Medium, 3+ = Hard)
     MiniMaxAlgo minimaxAlgo;  ///< Instance of the Minimax algorithm used for decision-making
+    OpeningBook book;         ///< Opening moves played without searching (empty if no book file)
+
+    bool pondered = false;    ///< True if the last ponder predicted a reply
+    uint64_t ponderKey = 0;   ///< Hash of the position the predicted reply leads to
+    int ponderHits = 0;       ///< Searches that started from the predicted position
+    int ponderMisses = 0;     ///< Searches that did not
 
 public:
     /**
@@ -59,13 +66,75 @@ public:
     /**
      * @brief Gets a random valid move for the AI to play.
      * 
-     * Iterates over all of the AI’s pieces and returns a random valid move.
+     * Picks uniformly among the AI's legal moves as listed by the board.
      * 
      * @param board The current state of the checkers board.
      * @return A pair consisting of the Piece to move and its target position (row, col),
      *         or {nullptr, {-1, -1}} if no valid move is found.
      */
     std::pair<Piece*, std::pair<int, int>> getRandomMove(CheckersBoard& board);
+
+    /**
+     * @brief Returns true if this difficulty uses the minimax search (Medium and Hard).
+     */
+    bool usesSearch() const;
+
+    /**
+     * @brief Returns the time budget of one search in milliseconds.
+     */
+    int searchTimeMillis() const;
+
+    /**
+     * @brief Runs the timed search on a board snapshot.
+     * 
+     * Plays from the opening book when it can. Qt-free, so CheckersManager
+     * runs it on its worker thread.
+     * 
+     * @param pos Snapshot of the board with Red to move.
+     * @param rootMoves Red's legal moves in that snapshot.
+     * @param token stopToken() read when the search was requested.
+     * @return The chosen move, or a null Move if there is none.
+     */
+    Move searchBestMove(const Position& pos, const MoveList& rootMoves, unsigned token);
+
+    /**
+     * @brief Searches the user's position until stopSearch() (pondering).
+     * 
+     * @param pos Snapshot of the board with Black (the user) to move.
+     * @param token stopToken() read when pondering was requested.
+     */
+    void ponder(const Position& pos, unsigned token);
+
+    /**
+     * @brief Sets a function the search calls after every completed iteration.
+     * 
+     * Called on the searching thread, for searchBestMove() and ponder() alike.
+     * 
+     * @param callback Receives the iteration's SearchInfo; empty to stop the reports.
+     */
+    void setSearchInfoCallback(std::function<void(const SearchInfo&)> callback);
+
+    /**
+     * @brief Makes a running searchBestMove() or ponder() return early. Safe from any thread.
+     */
+    void stopSearch();
+
+    /**
+     * @brief Returns the token to pass along with a search request so stopSearch() can cancel it.
+     */
+    unsigned stopToken() const;
+
+    /**
+     * @brief Converts a search Move back into a board move.
+     * 
+     * Only the first hop is returned; the board keeps the piece selected
+     * and asks the AI again for the rest of a capture chain.
+     * 
+     * @param board The board the move was searched on.
+     * @param move The move chosen by the search.
+     * @return A pair consisting of the Piece to move and its target position (row, col).
+     */
+    std::pair<Piece*, std::pair<int, int>> toBoardMove(CheckersBoard& board, const Move& move);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+/**
+ * @file AIWorker.cpp
+ * @brief Implements the QObject that runs AI searches on a background thread.
+ *
+ * CheckersManager moves one AIWorker onto its own QThread and talks to it only
+ * through queued signals, so the GUI thread never waits for the engine.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "AIWorker.h"
+
+/**
+ * @brief Constructs the worker and registers the types it passes across threads.
+ * 
+ * Also routes the AI's per-iteration reports into searchInfo(). They arrive
+ * on the worker's thread, so activeRequest needs no locking.
+ * 
+ * @param ai The AI player to search for.
+ */
+AIWorker::AIWorker(AI *ai) : ai(ai)
+{
+    qRegisterMetaType<Position>();
+    qRegisterMetaType<MoveList>();
+    qRegisterMetaType<Move>();
+    qRegisterMetaType<SearchInfo>();
+
+    ai->setSearchInfoCallback([this](const SearchInfo &info) {
+        if (activeRequest >= 0) {
+            emit searchInfo(activeRequest, info);
+        }
+    });
+}
+
+/**
+ * @brief Runs the timed search and emits the result.
+ * 
+ * Only the Qt-free Position snapshot is touched here; the board itself stays
+ * on the GUI thread.
+ */
+void AIWorker::search(int requestId, Position pos, MoveList rootMoves, unsigned token)
+{
+    activeRequest = requestId;
+    Move move = ai->searchBestMove(pos, rootMoves, token);
+    activeRequest = -1;
+    emit moveFound(requestId, move);
+}
+
+/**
+ * @brief Ponders on the user's time; returns once the AI is stopped.
+ */
+void AIWorker::ponder(Position pos, unsigned token)
+{
+    ai->ponder(pos, token);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file AIWorker.h
+ * @brief Implements the QObject that runs AI searches on a background thread.
+ *
+ * CheckersManager moves one AIWorker onto its own QThread and talks to it only
+ * through queued signals, so the GUI thread never waits for the engine.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef AIWORKER_H
+#define AIWORKER_H
+
+#include <QObject>
+#include <QMetaType>
+#include "AI.h"
+
+Q_DECLARE_METATYPE(Position)
+Q_DECLARE_METATYPE(MoveList)
+Q_DECLARE_METATYPE(Move)
+Q_DECLARE_METATYPE(SearchInfo)
+
+/**
+ * @class AIWorker
+ * @brief Runs AI::searchBestMove() and AI::ponder() on whichever thread it lives on.
+ */
+class AIWorker : public QObject {
+    Q_OBJECT
+
+private:
+    AI *ai;  ///< The AI whose search this worker runs (owned by CheckersManager)
+    int activeRequest = -1;  ///< Id of the search() in progress, -1 while idle or pondering
+
+public:
+    /**
+     * @brief Constructs a worker for the given AI.
+     * @param ai The AI player to search for.
+     */
+    explicit AIWorker(AI *ai);
+
+public slots:
+    /**
+     * @brief Searches a board snapshot and reports the chosen move.
+     * @param requestId Identifies the request so stale answers can be dropped.
+     * @param pos Snapshot of the board with Red to move.
+     * @param rootMoves Red's legal moves in that snapshot.
+     * @param token Stop token read when the search was requested.
+     */
+    void search(int requestId, Position pos, MoveList rootMoves, unsigned token);
+
+    /**
+     * @brief Searches the user's position until the AI is told to stop.
+     * @param pos Snapshot of the board with Black to move.
+     * @param token Stop token read when pondering was requested.
+     */
+    void ponder(Position pos, unsigned token);
+
+signals:
+    /**
+     * @brief Emitted when a search finishes (also after it was stopped early).
+     * @param requestId The id passed to search().
+     * @param move The chosen move, or a null Move if there is none.
+     */
+    void moveFound(int requestId, Move move);
+
+    /**
+     * @brief Emitted after every iteration of a search() (not while pondering).
+     * @param requestId The id passed to search().
+     * @param info Depth, nodes, rates, score and PV so far.
+     */
+    void searchInfo(int requestId, SearchInfo info);
+};
+
+#endif // AIWORKER_H
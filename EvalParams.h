@@ -0,0 +1,51 @@
+/**
+ * @file EvalParams.h
+ * @brief Default weights of the static evaluation.
+ *
+ * Square tables are given from Red's side of the board: entry 0 is on Red's
+ * back rank and entry 31 on the row where Red men are crowned. Black's tables
+ * are the same values with the board turned round (see EvalTables.h).
+ *
+ * A tuned set of weights in the same format can replace this file at build
+ * time: qmake "EVAL_PARAMS=/path/to/params.h".
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef EVALPARAMS_H
+#define EVALPARAMS_H
+
+namespace EvalParams {
+
+/// Value of a man on each square: base value, advancement and centre bonus,
+/// plus a point for staying on the back rank, where it stops enemy men crowning.
+constexpr int MAN_SQUARE[32] = {
+    4, 4, 4, 4,
+    3, 3, 3, 3,
+    4, 5, 5, 4,
+    4, 5, 5, 4,
+    5, 6, 6, 5,
+    5, 6, 6, 5,
+    6, 6, 6, 6,
+    6, 6, 6, 6
+};
+
+/// Value of a king on each square.
+constexpr int KING_SQUARE[32] = {
+    4, 4, 4, 4,
+    4, 4, 4, 4,
+    5, 6, 6, 5,
+    5, 6, 6, 5,
+    6, 7, 7, 6,
+    6, 7, 7, 6,
+    7, 7, 7, 7,
+    7, 7, 7, 7
+};
+
+constexpr int CAPTURE_THREAT = 3;  ///< For every piece that can capture
+constexpr int MOBILITY_TWO = 1;    ///< For every piece with at least two moves
+constexpr int MOBILITY_FOUR = 1;   ///< Again for every piece with four moves
+
+}
+
+#endif // EVALPARAMS_H
@@ -0,0 +1,58 @@
+/**
+ * @file EvalTables.h
+ * @brief Compile-time piece-square values for the static evaluation.
+ *
+ * The part of a piece's value that depends only on where it stands is one
+ * table entry per (side, man/king, square), built from the weights in
+ * EvalParams.h (or a tuned replacement). Position keeps the sum of these
+ * entries up to date in makeMove()/unmakeMove(), the same way it keeps its
+ * Zobrist key, so the evaluation never has to walk the pieces to get it.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef EVALTABLES_H
+#define EVALTABLES_H
+
+#include "Position.h"
+#include <cstdint>
+
+// The weights: the defaults, or a tuned file chosen when building
+#ifdef EVAL_PARAMS_FILE
+#include EVAL_PARAMS_FILE
+#else
+#include "EvalParams.h"
+#endif
+
+/**
+ * @struct EvalTables
+ * @brief Piece-square values for both sides.
+ */
+struct EvalTables {
+    int16_t pieceSquare[2][2][NUM_SQUARES] = {};  ///< [side][0 = man, 1 = king][square]
+};
+
+/// @brief Builds both sides' tables from the weights at compile time.
+constexpr EvalTables buildEvalTables() {
+    EvalTables tables;
+    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
+        // Black sees the board turned round: its square sq is Red's 31 - sq
+        int mirrored = NUM_SQUARES - 1 - sq;
+        tables.pieceSquare[0][0][sq] = static_cast<int16_t>(EvalParams::MAN_SQUARE[sq]);
+        tables.pieceSquare[0][1][sq] = static_cast<int16_t>(EvalParams::KING_SQUARE[sq]);
+        tables.pieceSquare[1][0][sq] = static_cast<int16_t>(EvalParams::MAN_SQUARE[mirrored]);
+        tables.pieceSquare[1][1][sq] = static_cast<int16_t>(EvalParams::KING_SQUARE[mirrored]);
+    }
+    return tables;
+}
+
+/// The piece-square values, generated at compile time.
+inline constexpr EvalTables EVAL_TABLES = buildEvalTables();
+
+/// @brief Piece-square value of one piece, positive for Red and negative for Black.
+constexpr int pieceSquareValue(Side side, bool king, int square) {
+    int value = EVAL_TABLES.pieceSquare[static_cast<int>(side)][king ? 1 : 0][square];
+    return side == Side::Red ? value : -value;
+}
+
+#endif // EVALTABLES_H
@@ -0,0 +1,86 @@
+/**
+ * @file Evaluation.h
+ * @brief The static evaluation, shared by the search and the weight tuner.
+ *
+ * A position is scored from Red's point of view as the piece-square sum that
+ * Position keeps up to date (see EvalTables.h) plus a capture and mobility
+ * term for each side. The terms are counted separately from their weights so
+ * the tuner can fit the weights to game results.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "EvalTables.h"
+#include "MoveTables.h"
+#include "Position.h"
+#include <cstdint>
+
+/**
+ * @struct MobilityTerms
+ * @brief Counts behind one side's capture and mobility score.
+ */
+struct MobilityTerms {
+    int captures = 0;   ///< Pieces that can capture
+    int twoMoves = 0;   ///< Pieces with at least two moves (steps and jumps)
+    int fourMoves = 0;  ///< Pieces with four moves
+};
+
+/// @brief Counts one side's mobility terms. The side is a template argument so
+///        the men's directions are constants.
+template <Side side>
+MobilityTerms mobilityTerms(const Position& pos) {
+    constexpr int firstForward = firstDirection(side, false);
+    constexpr int lastForward = lastDirection(side, false);
+
+    uint32_t own = pos.pieces(side);
+    uint32_t enemy = pos.pieces(opponent(side));
+    uint32_t empty = pos.empty();
+
+    uint32_t canMove[NUM_DIRECTIONS];
+    uint32_t canCapture = 0;
+    for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+        // Men only move forward; kings move both ways
+        bool forward = dir >= firstForward && dir < lastForward;
+        uint32_t movers = forward ? own : own & pos.kings;
+
+        // Walk back from the empty squares to the pieces that can reach them
+        int back = oppositeDirection(dir);
+        uint32_t stepFrom = shiftSquares(empty, back);
+        uint32_t jumpFrom = shiftSquares(stepFrom & enemy, back);
+        canMove[dir] = (stepFrom | jumpFrom) & movers;
+        canCapture |= jumpFrom & movers;
+    }
+
+    uint32_t atLeastTwo = (canMove[0] & (canMove[1] | canMove[2] | canMove[3]))
+                        | (canMove[1] & (canMove[2] | canMove[3]))
+                        | (canMove[2] & canMove[3]);
+    uint32_t allFour = canMove[0] & canMove[1] & canMove[2] & canMove[3];
+
+    MobilityTerms terms;
+    terms.captures = __builtin_popcount(canCapture);
+    terms.twoMoves = __builtin_popcount(atLeastTwo);
+    terms.fourMoves = __builtin_popcount(allFour);
+    return terms;
+}
+
+/// @brief Weighted capture and mobility score of one side.
+template <Side side>
+int mobilityScore(const Position& pos) {
+    MobilityTerms terms = mobilityTerms<side>(pos);
+    return EvalParams::CAPTURE_THREAT * terms.captures
+         + EvalParams::MOBILITY_TWO * terms.twoMoves
+         + EvalParams::MOBILITY_FOUR * terms.fourMoves;
+}
+
+/// @brief Static evaluation for side "us". The piece-square sum is kept from
+///        Red's point of view, so only its sign depends on the side.
+template <Side us>
+int evaluate(const Position& pos) {
+    int redScore = pos.psqt + mobilityScore<Side::Red>(pos) - mobilityScore<Side::Black>(pos);
+    return (us == Side::Red) ? redScore : -redScore;
+}
+
+#endif // EVALUATION_H
@@ -0,0 +1,91 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Implements a read-only memory mapping of a whole file.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// @brief Releases the mapping.
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+/// @brief Takes over another object's mapping.
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : base(std::exchange(other.base, nullptr)), length(std::exchange(other.length, 0)) {}
+
+/// @brief Releases this mapping and takes over another object's.
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        base = std::exchange(other.base, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+    return *this;
+}
+
+/// @brief Maps the whole file read-only.
+bool MappedFile::map(const std::string& path) {
+    unmap();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+    // The view keeps the mapping alive after its handle is closed
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view)
+        return false;
+    base = static_cast<const uint8_t*>(view);
+    length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+    base = static_cast<const uint8_t*>(view);
+    length = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+/// @brief Unmaps the file, if one is mapped.
+void MappedFile::unmap() {
+    if (!base)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+#else
+    munmap(const_cast<uint8_t*>(base), length);
+#endif
+    base = nullptr;
+    length = 0;
+}
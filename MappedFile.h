@@ -0,0 +1,57 @@
+/**
+ * @file MappedFile.h
+ * @brief Implements a read-only memory mapping of a whole file.
+ *
+ * Used for the endgame tablebases and the opening book: the operating system
+ * pages the data in on first touch and shares it between processes, so opening
+ * a large file is cheap and only the parts that are read cost memory.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Owns one read-only file mapping (mmap on POSIX, MapViewOfFile on Windows).
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Maps a file, releasing any previous mapping first.
+     * @param path The file.
+     * @return false if the file is missing, empty or cannot be mapped.
+     */
+    bool map(const std::string& path);
+
+    /// @brief Releases the mapping.
+    void unmap();
+
+    /// @brief Returns true while a file is mapped.
+    bool isMapped() const { return base != nullptr; }
+
+    /// @brief First byte of the file (nullptr if nothing is mapped).
+    const uint8_t* data() const { return base; }
+
+    /// @brief Length of the file in bytes.
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* base = nullptr;  ///< Start of the mapping
+    size_t length = 0;              ///< Length of the mapping
+};
+
+#endif // MAPPEDFILE_H
@@ -1,181 +1,722 @@
 /**
  * @file MiniMaxAlgo.cpp
  * @brief Implements the Minimax algorithm with alpha-beta pruning for AI gameplay in Checkers.
- * 
+ *
  * Contains logic for recursive game state evaluation, move simulation,
  * board evaluation heuristics, and iterative deepening with time constraints.
  * This class is used by the AI player to decide optimal moves.
- * 
+ *
+ * With more than one thread the search is "Lazy SMP": every thread runs the
+ * same iterative deepening (helpers skip some depths so they spread out) and
+ * they only cooperate through the shared transposition table.
+ *
  * @author Humzah Zahid Malik
  */
 
 #include "MiniMaxAlgo.h"
-#include <QDebug>
+#include "Evaluation.h"
+#include "Trace.h"
 #include <algorithm> // for std::max and std::min
+#include <cstdlib>   // for std::abs
+#include <thread>
+
+static_assert(MiniMaxAlgo::MAX_PLY < NnueStack::MAX_DEPTH, "the network stack must cover every ply");
+
+namespace {
+
+// Depth-skipping pattern of the helper threads, so they are usually a depth
+// ahead of or beside the main thread rather than duplicating it
+const int SKIP_SIZE[]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+const int SKIP_PHASE[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+// Score of a tablebase result for the side to move. A known distance gives
+// the same score the search would give the win or loss itself; without one a
+// win still outranks any evaluation but not a win the search has seen through
+int tablebaseScore(WDL result, int plies, int ply) {
+    if (result == WDL::Draw) return 0;
+    int score = (plies >= 0 && ply + plies < MiniMaxAlgo::MAX_PLY)
+        ? MiniMaxAlgo::WIN_SCORE - (ply + plies)
+        : MiniMaxAlgo::TB_WIN_SCORE - ply;
+    return (result == WDL::Win) ? score : -score;
+}
+
+}
 
-/// @brief Constructor that sets max search depth.
+/// @brief Constructor that sets max search depth and hash size.
 /// @param depth Max depth for minimax search.
-MiniMaxAlgo::MiniMaxAlgo(int depth) : maxDepth(depth) {}
+/// @param hashMB Transposition table size in MiB.
+MiniMaxAlgo::MiniMaxAlgo(int depth, size_t hashMB) : maxDepth(depth), tt(hashMB) {
+    setThreads(1);
+}
+
+/// @brief Sets the number of search threads.
+/// @param count Thread count, clamped to [1, MAX_THREADS].
+void MiniMaxAlgo::setThreads(int count) {
+    if (count < 1) count = 1;
+    if (count > MAX_THREADS) count = MAX_THREADS;
+    threads.clear();
+    for (int i = 0; i < count; ++i) {
+        threads.emplace_back(new SearchThread());
+        threads.back()->id = i;
+    }
+}
+
+/// @brief Returns the number of search threads.
+int MiniMaxAlgo::threadCount() const {
+    return static_cast<int>(threads.size());
+}
+
+/// @brief Resizes the transposition table.
+void MiniMaxAlgo::setHashSize(size_t megabytes) {
+    tt.resize(megabytes);
+}
+
+/// @brief Counts a stop request; searches started with an older token end.
+void MiniMaxAlgo::stop() {
+    stopRequests++;
+}
+
+/// @brief Returns the current stop token.
+unsigned MiniMaxAlgo::stopToken() const {
+    return stopRequests.load();
+}
+
+/// @brief Clears the transposition table and the move-ordering tables.
+void MiniMaxAlgo::clearHash() {
+    tt.clear();
+    for (auto& thread : threads)
+        thread->ordering.clear();
+}
+
+/// @brief Maps the endgame tables of a directory.
+int MiniMaxAlgo::loadTablebases(const std::string& directory) {
+    return tablebases.load(directory);
+}
+
+/// @brief Reads the network weights.
+bool MiniMaxAlgo::loadNetwork(const std::string& path) {
+    bool ok = network.load(path);
+    if (!ok && evaluator == Evaluator::Network)
+        setEvaluator(Evaluator::Classic);
+    return ok;
+}
+
+/// @brief Switches the evaluation; stored scores of the other one are discarded.
+bool MiniMaxAlgo::setEvaluator(Evaluator kind) {
+    if (kind == Evaluator::Network && !network.isLoaded())
+        return false;
+    if (kind != evaluator) {
+        evaluator = kind;
+        clearHash();
+    }
+    return true;
+}
+
+/// @brief Installs (or, with an empty function, removes) the per-iteration report.
+void MiniMaxAlgo::setInfoCallback(std::function<void(const SearchInfo&)> callback) {
+    onInfo = std::move(callback);
+}
+
+/// @brief Polls the clock every NODE_CHECK_INTERVAL nodes, publishing the thread's node count.
+/// @return true once the deadline has passed or stop() was called.
+bool MiniMaxAlgo::timeUp(SearchThread& thread) {
+    if (stopped.load(std::memory_order_relaxed)) return true;
+    uint64_t nodes = thread.stats.nodes + thread.stats.qnodes;
+    if ((nodes & (NODE_CHECK_INTERVAL - 1)) == 0) {
+        thread.publishedNodes.store(nodes, std::memory_order_relaxed);
+        if (stopRequests.load(std::memory_order_relaxed) != searchToken
+            || (hasDeadline && std::chrono::steady_clock::now() >= deadline))
+            stopped = true;
+    }
+    return stopped.load(std::memory_order_relaxed);
+}
 
-/// @brief Minimax algorithm with alpha-beta pruning.
-/// @param board Current game board.
+/// @brief Stores win/loss scores (tablebase ones included) as distance from this node rather than from the root.
+int MiniMaxAlgo::scoreToTT(int score, int ply) {
+    if (score > TB_WIN_SCORE - MAX_PLY) return score + ply;
+    if (score < -(TB_WIN_SCORE - MAX_PLY)) return score - ply;
+    return score;
+}
+
+/// @brief Re-bases a stored win/loss score on the current ply.
+int MiniMaxAlgo::scoreFromTT(int score, int ply) {
+    if (score > TB_WIN_SCORE - MAX_PLY) return score - ply;
+    if (score < -(TB_WIN_SCORE - MAX_PLY)) return score + ply;
+    return score;
+}
+
+/// @brief Minimax algorithm with alpha-beta pruning, written in negamax form.
+/// @param pos Current position.
 /// @param depth Recursion depth.
-/// @param isMaximizing True if AI's turn.
 /// @param alpha Alpha value for pruning.
 /// @param beta Beta value for pruning.
-/// @return Pair of best score and best move (pieceId, row, col).
-std::pair<int, std::tuple<int, int, int>>
-MiniMaxAlgo::minimax(CheckersBoard& board, int depth, bool isMaximizing, int alpha, int beta) {
-    // Stop if depth is 0 or game is over
-    if (depth == 0 || board.checkwin(PieceColor::Red) || board.checkwin(PieceColor::Black))
-        return { evaluateBoard(board), std::make_tuple(-1, -1, -1) };
+/// @param ply Distance from the root.
+/// @return Pair of best score (for the side to move) and best move.
+std::pair<int, Move> MiniMaxAlgo::minimax(Position& pos, int depth, int alpha, int beta, int ply) {
+    // A direct call is never timed or stopped
+    hasDeadline = false;
+    stopped = false;
+    searchToken = stopRequests.load();
+    probeInterior = true;
+    threads[0]->nnue.reset(pos, ply);
+    return minimax(*threads[0], pos, depth, alpha, beta, ply);
+}
+
+/// @brief Negamax search run by one search thread.
+/// @param thread The thread's own ordering tables and counters.
+/// @param pos Current position.
+/// @param depth Recursion depth.
+/// @param alpha Alpha value for pruning.
+/// @param beta Beta value for pruning.
+/// @param ply Distance from the root.
+/// @return Pair of best score (for the side to move) and best move.
+std::pair<int, Move> MiniMaxAlgo::minimax(SearchThread& thread, Position& pos, int depth,
+                                          int alpha, int beta, int ply) {
+    thread.stats.nodes++;
+    thread.stats.seldepth = std::max(thread.stats.seldepth, ply);
+
+    // Give up as soon as the deadline passes; the caller discards the result
+    if (timeUp(thread))
+        return { 0, Move() };
+
+    // Small endings are known exactly; the root is left to probeRoot()
+    int tbScore;
+    if (ply > 0 && probeTablebase(thread, pos, ply, tbScore))
+        return { tbScore, Move() };
+
+    // Stop at the horizon, but only once pending captures are resolved
+    if (depth == 0 || ply >= MAX_PLY)
+        return { quiesce(thread, pos, alpha, beta, ply), Move() };
+
+    // Look the position up; a deep enough result may settle it outright
+    uint64_t key = pos.hash();
+    TTEntry entry;
+    bool ttHit = tt.probe(key, entry);
+    thread.stats.ttProbes++;
+    if (ttHit) thread.stats.ttHits++;
+    if (ttHit && entry.depth() >= depth) {
+        int ttScore = scoreFromTT(entry.score(), ply);
+        if (entry.bound() == Bound::Exact
+            || (entry.bound() == Bound::Lower && ttScore >= beta)
+            || (entry.bound() == Bound::Upper && ttScore <= alpha))
+            return { ttScore, Move() };
+    }
+
+    MoveList moves;
+    generateMoves(pos, moves);
+
+    // A side with no legal move loses; prefer the quickest win / slowest loss
+    if (moves.empty())
+        return { -(WIN_SCORE - ply), Move() };
+
+    // Rank the moves: TT move, captures, killers, then history
+    int orderScores[MAX_MOVES];
+    thread.ordering.scoreMoves(pos, moves, ttHit ? &entry : nullptr, ply, orderScores);
 
     // Init best move and score
-    std::tuple<int, int, int> bestMove = std::make_tuple(-1, -1, -1);
-    int bestScore = isMaximizing ? std::numeric_limits<int>::min()
-                                 : std::numeric_limits<int>::max();
-
-    // Choose pieces based on current player
-    const QList<Piece*> pieces = isMaximizing ? board.getAIPieces() : board.getOpponentPieces();
-
-    // Loop through each piece
-    for (Piece* piece : pieces) {
-        if (!piece) continue;
-
-        // Try every square
-        for (int row = 0; row < 8; ++row) {
-            for (int col = 0; col < 8; ++col) {
-                if (!board.isValidMove(piece, row, col)) continue;
-
-                // Clone board for simulation
-                CheckersBoard* tempBoard = board.clone();
-
-                // Get matching piece in clone
-                Piece* tempPiece = tempBoard->getPieceAt(piece->getRow(), piece->getCol());
-                if (!tempPiece) {
-                    delete tempBoard;
-                    continue;
-                }
-
-                // Simulate the move
-                tempBoard->handleMove(tempPiece, row, col);
-
-                // Chain captures if possible
-                int maxChain = 12; // avoid infinite loops
-                while (tempBoard->isCaptureAvailable(tempPiece) && maxChain-- > 0) {
-                    bool foundNext = false;
-                    for (int r = 0; r < 8 && !foundNext; ++r) {
-                        for (int c = 0; c < 8; ++c) {
-                            if (tempBoard->isValidMove(tempPiece, r, c)) {
-                                tempBoard->handleMove(tempPiece, r, c);
-                                foundNext = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (!foundNext) break;
-                }
-
-                // Recursively evaluate
-                int score = minimax(*tempBoard, depth - 1, !isMaximizing, alpha, beta).first;
-                delete tempBoard;
-
-                // Update best score and move
-                if (isMaximizing && score > bestScore) {
-                    bestScore = score;
-                    bestMove = std::make_tuple(piece->getId(), row, col);
-                    alpha = std::max(alpha, bestScore);
-                } else if (!isMaximizing && score < bestScore) {
-                    bestScore = score;
-                    bestMove = std::make_tuple(piece->getId(), row, col);
-                    beta = std::min(beta, bestScore);
-                }
-
-                // Prune if possible
-                if (beta <= alpha) break;
-            }
-            if (beta <= alpha) break;
+    int alphaOrig = alpha;
+    Move bestMove;
+    int bestScore = std::numeric_limits<int>::min();
+
+    for (int i = 0; i < moves.size(); ++i) {
+        MoveOrderer::pickNext(moves, orderScores, i);
+        const Move& move = moves[i];
+
+        // Simulate the move in place (capture chains are part of the move)
+        MoveUndo undo;
+        pos.makeMove(move, undo);
+        if (evaluator == Evaluator::Network)
+            thread.nnue.push(ply + 1, pos);
+
+        // Principal variation search: the first move gets the full window, the rest
+        // a null window that only proves they are no better, re-searched if they are
+        int score;
+        if (i == 0) {
+            score = -minimax(thread, pos, depth - 1, -beta, -alpha, ply + 1).first;
+        } else {
+            score = -minimax(thread, pos, depth - 1, -alpha - 1, -alpha, ply + 1).first;
+            if (score > alpha && score < beta)
+                score = -minimax(thread, pos, depth - 1, -beta, -alpha, ply + 1).first;
+        }
+        pos.unmakeMove(move, undo);
+
+        // An aborted subtree returns garbage; unwind without storing anything
+        if (stopped)
+            return { 0, Move() };
+
+        // Update best score and move
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            alpha = std::max(alpha, bestScore);
+        }
+
+        // Prune if possible, remembering the move that did it
+        if (alpha >= beta) {
+            thread.stats.cutoffs++;
+            if (i == 0) thread.stats.firstMoveCutoffs++;
+            thread.ordering.recordCutoff(pos.sideToMove, move, depth, ply);
+            break;
         }
     }
 
+    // Remember the result for later iterations and later moves
+    Bound bound = (bestScore <= alphaOrig) ? Bound::Upper
+                : (bestScore >= beta) ? Bound::Lower : Bound::Exact;
+    tt.store(key, depth, scoreToTT(bestScore, ply), bound, bestMove);
+
     return { bestScore, bestMove };
 }
 
-/// @brief Evaluates current board state.
-/// @param board Board to evaluate.
-/// @return Score for AI (Red positive, Black negative).
-int MiniMaxAlgo::evaluateBoard(CheckersBoard& board) {
-    int score = 0;
-
-    // Go through all items on the board
-    for (QGraphicsItem* item : board.scene()->items()) {
-        Piece* piece = dynamic_cast<Piece*>(item);
-        if (!piece) continue;
-
-        // Base value: higher for king
-        int base = piece->isKing() ? 4 : 3;
-
-        // Bonus for advancing forward
-        int adv = (piece->getColor() == PieceColor::Red)
-                  ? static_cast<int>(piece->getRow() * 0.5)
-                  : static_cast<int>((7 - piece->getRow()) * 0.5);
-
-        // Bonus for being near center
-        int center = (piece->getRow() >= 2 && piece->getRow() <= 5 &&
-                      piece->getCol() >= 2 && piece->getCol() <= 5) ? 1 : 0;
-
-        // Bonus if captures are available
-        int capture = board.isCaptureAvailable(piece) ? 3 : 0;
-
-        // Bonus for move options
-        int mobility = 0;
-        for (int r = 0; r < 8; ++r) {
-            for (int c = 0; c < 8; ++c) {
-                if (board.isValidMove(piece, r, c))
-                    mobility++;
-            }
+/// @brief Capture-only search below the horizon.
+/// @param thread The searching thread.
+/// @param pos Current position.
+/// @param alpha Alpha value for pruning.
+/// @param beta Beta value for pruning.
+/// @param ply Distance from the root.
+/// @return Score for the side to move once no capture is pending.
+int MiniMaxAlgo::quiesce(SearchThread& thread, Position& pos, int alpha, int beta, int ply) {
+    thread.stats.qnodes++;
+    thread.stats.seldepth = std::max(thread.stats.seldepth, ply);
+    if (timeUp(thread))
+        return 0;
+
+    int tbScore;
+    if (probeTablebase(thread, pos, ply, tbScore))
+        return tbScore;
+
+    // Quiet position (or too deep): the static evaluation is reliable
+    MoveList captures;
+    generateCaptures(pos, captures);
+
+    // No capture and no quiet move either: the side to move has lost
+    if (captures.empty() && !hasLegalMove(pos))
+        return -(WIN_SCORE - ply);
+
+    if (captures.empty() || ply >= MAX_PLY) {
+        TRACE_SCOPE_IF((thread.stats.qnodes & (EVAL_TRACE_INTERVAL - 1)) == 0, "static evaluation (sampled)");
+        if (evaluator == Evaluator::Network)
+            return thread.nnue.evaluate(network, ply);
+        return (pos.sideToMove == Side::Red) ? evaluate<Side::Red>(pos) : evaluate<Side::Black>(pos);
+    }
+
+    // Captures are mandatory, so there is no standing pat: one of them must be played
+    int orderScores[MAX_MOVES];
+    thread.ordering.scoreMoves(pos, captures, nullptr, ply, orderScores);
+
+    int bestScore = std::numeric_limits<int>::min();
+    for (int i = 0; i < captures.size(); ++i) {
+        MoveOrderer::pickNext(captures, orderScores, i);
+
+        MoveUndo undo;
+        pos.makeMove(captures[i], undo);
+        if (evaluator == Evaluator::Network)
+            thread.nnue.push(ply + 1, pos);
+        int score = -quiesce(thread, pos, -beta, -alpha, ply + 1);
+        pos.unmakeMove(captures[i], undo);
+
+        if (stopped)
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            alpha = std::max(alpha, score);
         }
-        int mobilityBonus = mobility / 2;
+        if (alpha >= beta) break;
+    }
 
-        // Final piece score
-        int pieceScore = base + adv + center + capture + mobilityBonus;
+    return bestScore;
+}
+
+/// @brief Probes the tablebases if the position has few enough pieces.
+/// @param thread The searching thread.
+/// @param pos Current position.
+/// @param ply Distance from the root.
+/// @param score Receives the score for the side to move.
+/// @return true if the tables know the position.
+bool MiniMaxAlgo::probeTablebase(SearchThread& thread, const Position& pos, int ply, int& score) {
+    // Cheap piece count first: most of the game never gets near the tables
+    if (!probeInterior || __builtin_popcount(pos.occupied()) > tablebases.maxPieces())
+        return false;
+
+    WDL result;
+    int plies;
+    if (!tablebases.probe(pos, result, plies, thread.tbCache))
+        return false;
+
+    thread.stats.tbHits++;
+    score = tablebaseScore(result, plies, ply);
+    return true;
+}
 
-        // Add/subtract to total score
-        score += (piece->getColor() == PieceColor::Red) ? pieceScore : -pieceScore;
+/// @brief Adds up the counters of the shared cache and of every thread's cache.
+TBProbeStats MiniMaxAlgo::tablebaseStats() const {
+    TBProbeStats total = tablebases.stats();
+    for (const auto& thread : threads) {
+        TBProbeStats part = thread->tbCache.stats();
+        total.probes += part.probes;
+        total.hits += part.hits;
+        total.blockHits += part.blockHits;
+        total.blockMisses += part.blockMisses;
     }
+    return total;
+}
 
-    return score;
+/// @brief Settles or narrows the root moves from the tablebases.
+/// @param pos Root position.
+/// @param rootMoves Legal moves; narrowed to those keeping the best result.
+/// @return The best move if distances decide it, otherwise a null Move.
+Move MiniMaxAlgo::probeRoot(const Position& pos, MoveList& rootMoves) {
+    probeInterior = true;
+    if (rootMoves.empty() || __builtin_popcount(pos.occupied()) > tablebases.maxPieces())
+        return Move();
+
+    // Score every move by the table entry of the position it leads to
+    int scores[MAX_MOVES] = {};
+    bool allDistances = true;
+    for (int i = 0; i < rootMoves.size(); ++i) {
+        Position child = pos;
+        child.applyMove(rootMoves[i]);
+
+        WDL result;
+        int plies;
+        if (child.pieces(child.sideToMove) == 0) {
+            result = WDL::Loss;  // The move captures the last piece
+            plies = 0;
+        } else if (!tablebases.probe(child, result, plies)) {
+            return Move();
+        }
+
+        scores[i] = -tablebaseScore(result, plies, 1);
+        if (result != WDL::Draw && plies < 0)
+            allDistances = false;
+    }
+
+    int best = 0;
+    for (int i = 1; i < rootMoves.size(); ++i)
+        if (scores[i] > scores[best])
+            best = i;
+
+    // Distances pick the fastest win or slowest loss outright
+    if (scores[best] != 0 && allDistances)
+        return rootMoves[best];
+
+    // Otherwise keep the moves with the best result and let the evaluation choose
+    // among them; tablebase scores below the root would make them all look equal
+    auto outcome = [](int score) { return (score > 0) - (score < 0); };
+    MoveList kept;
+    for (int i = 0; i < rootMoves.size(); ++i)
+        if (outcome(scores[i]) == outcome(scores[best]))
+            kept.add(rootMoves[i]);
+    rootMoves = kept;
+    probeInterior = false;
+    return Move();
+}
+
+/// @brief Searches the root moves with principal variation search.
+/// @param thread The searching thread.
+/// @param board Root position (restored on return).
+/// @param rootMoves Root moves, best first.
+/// @param depth Depth of this iteration.
+/// @param alpha Lower end of the window.
+/// @param beta Upper end of the window.
+/// @param bestIndex Receives the index of the best move (0 if none beat alpha).
+/// @return Best score, or a bound on it if the window failed.
+int MiniMaxAlgo::searchRoot(SearchThread& thread, Position& board, const MoveList& rootMoves, int depth,
+                            int alpha, int beta, int& bestIndex) {
+    int bestScore = -9999;
+    bestIndex = 0;
+
+    for (int i = 0; i < rootMoves.size(); ++i) {
+        MoveUndo undo;
+        board.makeMove(rootMoves[i], undo);
+        if (evaluator == Evaluator::Network)
+            thread.nnue.push(1, board);
+
+        int score;
+        if (i == 0) {
+            score = -minimax(thread, board, depth - 1, -beta, -alpha, 1).first;
+        } else {
+            score = -minimax(thread, board, depth - 1, -alpha - 1, -alpha, 1).first;
+            if (score > alpha && score < beta)
+                score = -minimax(thread, board, depth - 1, -beta, -alpha, 1).first;
+        }
+        board.unmakeMove(rootMoves[i], undo);
+        if (stopped) break;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestIndex = i;
+            alpha = std::max(alpha, score);
+        }
+        if (alpha >= beta) break;
+    }
+
+    return bestScore;
+}
+
+/// @brief Evaluates current position.
+/// @param pos Position to evaluate.
+/// @return Score for AI (Red positive, Black negative).
+int MiniMaxAlgo::evaluateBoard(const Position& pos) {
+    if (evaluator == Evaluator::Network) {
+        int score = network.evaluate(pos);
+        return (pos.sideToMove == Side::Red) ? score : -score;
+    }
+    return evaluate<Side::Red>(pos);
 }
 
 /// @brief Iterative deepening Minimax with time limit.
-/// @param board Game board.
+/// @param pos Root position.
 /// @param timeLimitMillis Time cap in milliseconds.
-/// @return Best move found (pieceId, row, col).
-std::tuple<int, int, int> MiniMaxAlgo::getBestTimedMove(CheckersBoard& board, int timeLimitMillis) {
+/// @return Best move found.
+Move MiniMaxAlgo::getBestTimedMove(const Position& pos, int timeLimitMillis) {
+    MoveList rootMoves;
+    generateMoves(pos, rootMoves);
+    return getBestTimedMove(pos, rootMoves, timeLimitMillis);
+}
+
+/// @brief Iterative deepening Minimax over a fixed set of root moves.
+/// @param pos Root position.
+/// @param rootMoves Legal moves to choose from.
+/// @param timeLimitMillis Time cap in milliseconds.
+/// @return Best move found.
+Move MiniMaxAlgo::getBestTimedMove(const Position& pos, const MoveList& rootMoves, int timeLimitMillis) {
+    return getBestTimedMove(pos, rootMoves, timeLimitMillis, stopToken());
+}
+
+/// @brief Iterative deepening Minimax that another thread can cancel.
+/// @param pos Root position.
+/// @param rootMoves Legal moves to choose from.
+/// @param timeLimitMillis Time cap in milliseconds.
+/// @param token stopToken() read when the search was requested.
+/// @return Best move found.
+Move MiniMaxAlgo::getBestTimedMove(const Position& pos, const MoveList& rootMoves, int timeLimitMillis,
+                                   unsigned token) {
+    stats = SearchStats();
+
+    // Nothing to search with zero or one choice
+    if (rootMoves.empty())
+        return Move();
+    if (rootMoves.size() == 1)
+        return rootMoves[0];
+
+    // The endgame tables may decide the move, or at least rule out the ones that throw a result away
+    MoveList moves = rootMoves;
+    Move tbMove = probeRoot(pos, moves);
+    if (!tbMove.isNull())
+        return tbMove;
+    if (moves.size() == 1)
+        return moves[0];
+
+    return runSearch(pos, moves, timeLimitMillis, token);
+}
+
+/// @brief Searches the opponent's position until stopped.
+/// @param pos Position with the opponent to move.
+/// @param token stopToken() read when pondering was requested.
+/// @return The opponent's expected move.
+Move MiniMaxAlgo::ponder(const Position& pos, unsigned token) {
+    MoveList rootMoves;
+    generateMoves(pos, rootMoves);
+    if (rootMoves.empty())
+        return Move();
+
+    // The opponent may not play the tablebase move, so only narrow the root here
+    probeRoot(pos, rootMoves);
+
+    // Even a forced reply is worth searching: it fills the table for our next move
+    return runSearch(pos, rootMoves, -1, token);
+}
+
+/// @brief Runs every search thread on one root.
+/// @param pos Root position.
+/// @param rootMoves Legal moves to choose from (at least one).
+/// @param timeLimitMillis Time cap in milliseconds, or negative to search until stopped.
+/// @param token Stop token the search belongs to.
+/// @return Best move of the main thread's last completed iteration.
+Move MiniMaxAlgo::runSearch(const Position& pos, const MoveList& rootMoves, int timeLimitMillis,
+                            unsigned token) {
+    TRACE_SCOPE_ARG("search", "threads", static_cast<int64_t>(threads.size()));
     using namespace std::chrono;
-    auto start = high_resolution_clock::now(); // start timer
+    auto start = steady_clock::now(); // start timer
 
-    std::tuple<int, int, int> bestMove = std::make_tuple(-1, -1, -1);
+    tt.newSearch();
+    for (auto& thread : threads) {
+        thread->ordering.newSearch();
+        thread->stats = SearchStats();
+        thread->publishedNodes = 0;
+    }
 
-    // Increase depth gradually
-    for (int d = 1; d <= maxDepth; ++d) {
-        // Check time
-        auto elapsed = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
-        if (elapsed >= timeLimitMillis) break;
+    // The search itself polls the deadline and the stop token, so no iteration can overrun them
+    deadline = start + milliseconds(std::max(timeLimitMillis, 0));
+    hasDeadline = timeLimitMillis >= 0;
+    searchToken = token;
+    stopped = false;
+
+    // Helpers search until the main thread is done; only its move is played
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < threads.size(); ++i)
+        helpers.emplace_back([this, i, &pos, &rootMoves, start, timeLimitMillis] {
+            iterativeDeepening(*threads[i], pos, rootMoves, start, timeLimitMillis);
+        });
+
+    Move bestMove = iterativeDeepening(*threads[0], pos, rootMoves, start, timeLimitMillis);
+    stopped = true;
+    for (std::thread& helper : helpers)
+        helper.join();
+    hasDeadline = false;
+
+    // Report the work of every thread, but the depth the main thread completed
+    stats = SearchStats();
+    for (auto& thread : threads) {
+        stats.nodes += thread->stats.nodes;
+        stats.qnodes += thread->stats.qnodes;
+        stats.cutoffs += thread->stats.cutoffs;
+        stats.firstMoveCutoffs += thread->stats.firstMoveCutoffs;
+        stats.tbHits += thread->stats.tbHits;
+        stats.ttProbes += thread->stats.ttProbes;
+        stats.ttHits += thread->stats.ttHits;
+        stats.seldepth = std::max(stats.seldepth, thread->stats.seldepth);
+    }
+    stats.depth = threads[0]->stats.depth;
+    stats.score = threads[0]->stats.score;
+    stats.elapsedMicros = duration_cast<microseconds>(steady_clock::now() - start).count();
 
-        // Clone board and run minimax
-        CheckersBoard* tempBoard = board.clone();
-        auto result = minimax(*tempBoard, d, true, -9999, 9999);
-        delete tempBoard;
+    return bestMove;
+}
 
-        bestMove = std::get<1>(result);
+/// @brief Iterative deepening loop of one search thread.
+/// @param thread The searching thread (0 is the main thread).
+/// @param pos Root position.
+/// @param rootMoves Legal moves to choose from.
+/// @param start When the search started.
+/// @param timeLimitMillis Time cap in milliseconds (negative: until stopped).
+/// @return Best move of the last completed iteration.
+Move MiniMaxAlgo::iterativeDeepening(SearchThread& thread, const Position& pos, const MoveList& rootMoves,
+                                     std::chrono::steady_clock::time_point start, int timeLimitMillis) {
+    using namespace std::chrono;
 
-        // Check time again after iteration
-        elapsed = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
-        if (elapsed >= timeLimitMillis) break;
+    Move bestMove = rootMoves[0];
+    Position board = pos;  // The one position this thread mutates
+    thread.nnue.reset(board);
+
+    // Root moves in the order they will be searched; the previous best goes first
+    MoveList ordered = rootMoves;
+    TTEntry entry;
+    if (tt.probe(board.hash(), entry)) {
+        for (int i = 1; i < ordered.size(); ++i) {
+            if (entry.matches(ordered[i])) {
+                std::swap(ordered[0], ordered[i]);
+                break;
+            }
+        }
     }
 
-    auto total = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    // Increase depth gradually
+    int prevScore = 0;
+    for (int d = 1; d <= maxDepth; ++d) {
+        if (thread.id == 0) {
+            // Don't start an iteration that has no chance of finishing in time
+            auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start).count();
+            if (timeLimitMillis >= 0 && d > 1 && elapsed * 2 >= timeLimitMillis) break;
+        } else {
+            // Helpers skip depths in a per-thread pattern
+            int i = (thread.id - 1) % 20;
+            if (((d + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2) continue;
+        }
+        TRACE_SCOPE_ARG("search iteration", "depth", d);
+
+        // Aspiration window around the previous score; full window for the first
+        // iterations and once a forced win or loss has been seen
+        int window = ASPIRATION_WINDOW;
+        bool aspirate = d > 2 && std::abs(prevScore) < TB_WIN_SCORE - MAX_PLY;
+        int alpha = aspirate ? prevScore - window : -9999;
+        int beta = aspirate ? prevScore + window : 9999;
+
+        int bestIndex = 0;
+        int score;
+        while (true) {
+            score = searchRoot(thread, board, ordered, d, alpha, beta, bestIndex);
+            if (stopped) break;
+
+            // Widen whichever side failed and search again
+            if (score <= alpha && alpha > -9999) {
+                window *= 2;
+                alpha = std::max(-9999, score - window);
+            } else if (score >= beta && beta < 9999) {
+                window *= 2;
+                beta = std::min(9999, score + window);
+            } else {
+                break;
+            }
+        }
+
+        // Out of time: keep the move from the last completed iteration
+        if (stopped) break;
+
+        // Search the best move first in the next iteration
+        prevScore = score;
+        bestMove = ordered[bestIndex];
+        std::swap(ordered[0], ordered[bestIndex]);
+        thread.stats.depth = d;
+        thread.stats.score = score;
+        if (thread.id == 0 && onInfo)
+            onInfo(searchInfo(pos, bestMove, start));
+    }
 
     return bestMove;
-}
\ No newline at end of file
+}
+
+/// @brief Replays the stored best moves from the root until the table runs out or a position repeats.
+/// @param root Root position.
+/// @param first Move chosen at the root.
+/// @param maxLength Longest line returned.
+/// @return The expected line, starting with first.
+std::vector<Move> MiniMaxAlgo::principalVariation(const Position& root, const Move& first, int maxLength) const {
+    std::vector<Move> line = { first };
+    std::vector<uint64_t> seen = { root.hash() };
+    Position pos = root;
+    pos.applyMove(first);
+
+    while (static_cast<int>(line.size()) < maxLength) {
+        TTEntry entry;
+        if (std::find(seen.begin(), seen.end(), pos.hash()) != seen.end() || !tt.probe(pos.hash(), entry))
+            break;
+        seen.push_back(pos.hash());
+
+        MoveList moves;
+        generateMoves(pos, moves);
+        const Move* next = std::find_if(moves.begin(), moves.end(),
+                                        [&entry](const Move& move) { return entry.matches(move); });
+        if (next == moves.end())
+            break;
+        line.push_back(*next);
+        pos.applyMove(*next);
+    }
+    return line;
+}
+
+/// @brief Gathers the main thread's counters, every thread's published nodes and the PV.
+/// @param root Root position.
+/// @param best Best move of the iteration just completed.
+/// @param start When the search started.
+/// @return The report passed to the info callback.
+SearchInfo MiniMaxAlgo::searchInfo(const Position& root, const Move& best,
+                                   std::chrono::steady_clock::time_point start) const {
+    using namespace std::chrono;
+    const SearchStats& main = threads[0]->stats;
+
+    SearchInfo info;
+    info.depth = main.depth;
+    info.seldepth = main.seldepth;
+    info.score = main.score;
+    info.nodes = main.nodes + main.qnodes;
+    for (size_t i = 1; i < threads.size(); ++i)
+        info.nodes += threads[i]->publishedNodes.load(std::memory_order_relaxed);
+    info.elapsedMicros = duration_cast<microseconds>(steady_clock::now() - start).count();
+    info.ttHitRate = main.ttHitRate();
+    info.firstMoveCutoffRate = main.firstMoveCutoffRate();
+    info.pv = principalVariation(root, best, main.depth);
+    return info;
+}
@@ -1,65 +1,374 @@
 /**
  * @file MiniMaxAlgo.h
  * @brief Implements the Minimax algorithm with alpha-beta pruning for AI gameplay in Checkers.
- * 
+ *
  * Contains logic for recursive game state evaluation, move simulation,
  * board evaluation heuristics, and iterative deepening with time constraints.
  * This class is used by the AI player to decide optimal moves.
- * 
+ *
+ * The search runs entirely on the bitboard Position type; the caller converts
+ * the CheckersBoard to a Position once at the root.
+ *
  * @author Humzah Zahid Malik
  */
 
 #ifndef MINIMAXALGO_H
 #define MINIMAXALGO_H
 
-#include "checkersboard.h"  // Use CheckersBoard instead of Board
-#include "piece.h"          // Include Piece class
+#include "Position.h"
+#include "MoveGen.h"
+#include "TranspositionTable.h"
+#include "MoveOrder.h"
+#include "Nnue.h"
+#include "TablebaseProbe.h"
 #include <utility>
 #include <limits>
+#include <atomic>
 #include <chrono>
-#include <tuple> // for std::tuple
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @struct SearchStats
+ * @brief Node and cutoff counters of the last search, used to check move ordering.
+ */
+struct SearchStats {
+    uint64_t nodes = 0;             ///< Nodes visited by the full-width search
+    uint64_t qnodes = 0;            ///< Nodes visited by the capture-only quiescence search
+    uint64_t cutoffs = 0;           ///< Nodes that failed high
+    uint64_t firstMoveCutoffs = 0;  ///< Fail-highs caused by the first move searched
+    uint64_t tbHits = 0;            ///< Nodes scored from the endgame tablebases
+    uint64_t ttProbes = 0;          ///< Transposition table lookups of the full-width search
+    uint64_t ttHits = 0;            ///< Lookups that found the position
+    int depth = 0;                  ///< Deepest iteration the main thread completed
+    int seldepth = 0;               ///< Deepest ply reached, quiescence included
+    int score = 0;                  ///< Score of that iteration, for the side to move
+    int64_t elapsedMicros = 0;      ///< Wall time of the whole search
+
+    /// @brief Fraction of fail-highs that happened on the first move (1.0 = perfect ordering).
+    double firstMoveCutoffRate() const {
+        return cutoffs ? static_cast<double>(firstMoveCutoffs) / cutoffs : 0.0;
+    }
+
+    /// @brief Fraction of table lookups that found the position.
+    double ttHitRate() const {
+        return ttProbes ? static_cast<double>(ttHits) / ttProbes : 0.0;
+    }
+
+    /// @brief Full-width and quiescence nodes per second of wall time.
+    double nodesPerSecond() const {
+        return elapsedMicros > 0 ? (nodes + qnodes) * 1e6 / elapsedMicros : 0.0;
+    }
+};
+
+/**
+ * @struct SearchInfo
+ * @brief Progress of a search, reported after every iteration the main thread completes.
+ *
+ * Nodes count every thread (helpers publish theirs every NODE_CHECK_INTERVAL
+ * nodes); the rates come from the main thread alone.
+ */
+struct SearchInfo {
+    int depth = 0;                    ///< Iteration just completed
+    int seldepth = 0;                 ///< Deepest ply reached so far, quiescence included
+    int score = 0;                    ///< Score for the side to move at the root
+    uint64_t nodes = 0;               ///< Full-width and quiescence nodes so far
+    int64_t elapsedMicros = 0;        ///< Time since the search started
+    double ttHitRate = 0.0;           ///< Fraction of table lookups that found the position
+    double firstMoveCutoffRate = 0.0; ///< Fraction of fail-highs caused by the first move
+    std::vector<Move> pv;             ///< Expected line from the root, read back from the table
+
+    /// @brief Nodes per second so far.
+    double nodesPerSecond() const {
+        return elapsedMicros > 0 ? nodes * 1e6 / elapsedMicros : 0.0;
+    }
+};
+
+/**
+ * @struct SearchThread
+ * @brief Everything one search thread owns; only the transposition table is shared.
+ */
+struct SearchThread {
+    int id = 0;             ///< 0 for the main thread, 1.. for helpers
+    MoveOrderer ordering;   ///< Killer and history tables
+    SearchStats stats;      ///< Counters of the current search
+    NnueStack nnue;         ///< Network accumulators along the current line
+    TBBlockCache tbCache;   ///< Decompressed tablebase blocks, so probes never lock
+    std::atomic<uint64_t> publishedNodes{0};  ///< Node count other threads may read (see timeUp())
+};
+
+/**
+ * @enum Evaluator
+ * @brief Which static evaluation the search uses.
+ */
+enum class Evaluator {
+    Classic,  ///< Hand-written piece-square and mobility terms (Evaluation.h)
+    Network   ///< The neural network (Nnue.h), once one is loaded
+};
 
 /**
  * @class MiniMaxAlgo
  * @brief Implements the Minimax Algorithm with Alpha-Beta Pruning for AI decision-making.
- * 
+ *
  * This class evaluates board states and selects optimal moves for the AI.
  */
 class MiniMaxAlgo {
 private:
-    int maxDepth;  ///< Maximum search depth for Minimax
+    int maxDepth;            ///< Maximum search depth for Minimax
+    TranspositionTable tt;   ///< Results kept across iterations and moves, shared by all threads
+    std::vector<std::unique_ptr<SearchThread>> threads;  ///< threads[0] is the main thread
+    SearchStats stats;       ///< Counters of the last search, summed over threads
+    TablebaseProbe tablebases;  ///< Endgame tables; empty unless loadTablebases() found some
+    bool probeInterior = true;  ///< Score tablebase positions below the root (off when the root filtered by WDL)
+    NnueNetwork network;     ///< Network weights; empty unless loadNetwork() succeeded
+    Evaluator evaluator = Evaluator::Classic;  ///< Evaluation used by the search
+
+    std::chrono::steady_clock::time_point deadline;  ///< When the current search must stop
+    bool hasDeadline = false;            ///< False when minimax is called directly, without a time limit
+    std::atomic<bool> stopped{false};    ///< Set once the search must end; unwinds every thread
+    std::atomic<unsigned> stopRequests{0};  ///< Bumped by stop(); a search ends when it no longer matches
+    unsigned searchToken = 0;            ///< stopRequests value the current search was started with
+
+    std::function<void(const SearchInfo&)> onInfo;  ///< Called after each main-thread iteration, if set
+
+    /// @brief Checks the deadline and stop requests every NODE_CHECK_INTERVAL nodes of a thread,
+    /// and publishes the thread's node count for progress reports.
+    /// @return true if the search must stop.
+    bool timeUp(SearchThread& thread);
+
+    /// @brief Follows the table's best moves from the root, starting with the move just chosen.
+    std::vector<Move> principalVariation(const Position& root, const Move& first, int maxLength) const;
+
+    /// @brief Builds the progress report of the iteration the main thread just completed.
+    SearchInfo searchInfo(const Position& root, const Move& best, std::chrono::steady_clock::time_point start) const;
+
+    /// @brief Negamax search of one thread (see the public minimax()).
+    std::pair<int, Move> minimax(SearchThread& thread, Position& pos, int depth, int alpha, int beta, int ply);
+
+    /**
+     * @brief Runs every search thread on one root and returns the main thread's move.
+     * @param pos The root position.
+     * @param rootMoves The legal moves to choose from (at least one).
+     * @param timeLimitMillis The time limit in milliseconds, or negative to search until stopped.
+     * @param token The stop token the search belongs to.
+     * @return Best move of the main thread's last completed iteration.
+     */
+    Move runSearch(const Position& pos, const MoveList& rootMoves, int timeLimitMillis, unsigned token);
+
+    /**
+     * @brief Runs iterative deepening on one thread until the depth cap or the stop flag.
+     * @param thread The searching thread; helpers skip some depths.
+     * @param pos The root position.
+     * @param rootMoves The legal moves to choose from.
+     * @param start When the search started.
+     * @param timeLimitMillis The time limit in milliseconds (negative: until stopped).
+     * @return Best move of the last iteration the thread completed.
+     */
+    Move iterativeDeepening(SearchThread& thread, const Position& pos, const MoveList& rootMoves,
+                            std::chrono::steady_clock::time_point start, int timeLimitMillis);
+
+    /**
+     * @brief Searches every root move once with principal variation search.
+     * @param thread The searching thread.
+     * @param board Root position (restored on return).
+     * @param rootMoves Root moves, best first.
+     * @param depth Depth of this iteration.
+     * @param alpha Lower end of the window.
+     * @param beta Upper end of the window.
+     * @param bestIndex Receives the index of the best move.
+     * @return Best score, or a bound on it if it falls outside the window.
+     */
+    int searchRoot(SearchThread& thread, Position& board, const MoveList& rootMoves, int depth, int alpha, int beta, int& bestIndex);
+
+    /**
+     * @brief Resolves pending captures before the position is evaluated.
+     * @param thread The searching thread.
+     * @param pos The position; moves are made and unmade in place.
+     * @param alpha The alpha value for pruning.
+     * @param beta The beta value for pruning.
+     * @param ply Distance from the root.
+     * @return Score for the side to move.
+     */
+    int quiesce(SearchThread& thread, Position& pos, int alpha, int beta, int ply);
+
+    /**
+     * @brief Scores a position from the endgame tablebases.
+     * @param thread The searching thread (counts the hit).
+     * @param pos The position.
+     * @param ply Distance from the root.
+     * @param score Receives the exact score for the side to move.
+     * @return false if the position is not in the loaded tables.
+     */
+    bool probeTablebase(SearchThread& thread, const Position& pos, int ply, int& score);
+
+    /**
+     * @brief Settles or narrows the root from the tablebases.
+     *
+     * With distance tables the best move is known outright. With win/loss/draw
+     * tables only the moves that keep the best result are left for the search,
+     * which then plays on its evaluation so that it still makes progress.
+     *
+     * @param pos The root position.
+     * @param rootMoves The legal moves; narrowed in place.
+     * @return The move to play, or a null Move if the search must still choose.
+     */
+    Move probeRoot(const Position& pos, MoveList& rootMoves);
+
+    /// @brief Converts a score to its TT form (win/loss distance relative to the node).
+    static int scoreToTT(int score, int ply);
+
+    /// @brief Converts a TT score back to a score relative to the root.
+    static int scoreFromTT(int score, int ply);
 
 public:
+    static const int WIN_SCORE = 5000;  ///< Score for a side whose opponent is left without moves
+    static const int MAX_PLY = 128;     ///< Deepest ply the search can reach
+    static const int ASPIRATION_WINDOW = 4;  ///< Half-width of the first aspiration window
+    static const int MAX_SEARCH_DEPTH = 64;  ///< Depth cap when only the clock should limit the search
+    static const int NODE_CHECK_INTERVAL = 1024;  ///< Nodes between clock checks (power of two)
+    static const int EVAL_TRACE_INTERVAL = 1024;  ///< Quiescence nodes per traced static evaluation (power of two)
+    static const int MAX_THREADS = 64;       ///< Upper bound for setThreads()
+    static const int TB_WIN_SCORE = WIN_SCORE - 2 * MAX_PLY;  ///< Tablebase win without a known distance
+
     /**
      * @brief Constructor for MiniMaxAlgo.
      * @param depth The maximum depth for Minimax recursion.
+     * @param hashMB Transposition table size in MiB.
+     */
+    MiniMaxAlgo(int depth, size_t hashMB = 16);
+
+    /**
+     * @brief Resizes (and clears) the transposition table.
+     * @param megabytes New size in MiB.
+     */
+    void setHashSize(size_t megabytes);
+
+    /**
+     * @brief Sets how many threads search each move (Lazy SMP).
+     * @param count Number of threads, 1 for a single-threaded search.
+     */
+    void setThreads(int count);
+
+    /// @brief Returns the number of search threads.
+    int threadCount() const;
+
+    /**
+     * @brief Makes running searches return as soon as possible.
+     *
+     * Safe to call from another thread. Also ends a search that has not started
+     * yet if it was requested with a token read before this call.
+     */
+    void stop();
+
+    /// @brief Returns the token to pass to a search that stop() must be able to cancel.
+    unsigned stopToken() const;
+
+    /// @brief Forgets every stored result, e.g. when a new game starts.
+    void clearHash();
+
+    /**
+     * @brief Maps the endgame tablebases found in a directory.
+     * @param directory Directory written by the tbgen tool.
+     * @return Number of tables loaded.
+     */
+    int loadTablebases(const std::string& directory);
+
+    /// @brief Returns the tablebases, e.g. for their piece count.
+    const TablebaseProbe& endgameTables() const { return tablebases; }
+
+    /// @brief Returns the tablebase probe and block cache counters, summed over every cache.
+    TBProbeStats tablebaseStats() const;
+
+    /**
+     * @brief Reads the network weights for Evaluator::Network.
+     * @param path Weights file (see Nnue.h for the format).
+     * @return true if the network was loaded.
+     */
+    bool loadNetwork(const std::string& path);
+
+    /**
+     * @brief Chooses the static evaluation; clears the hash when it changes.
+     * @return false (keeping the current one) if the network is asked for but not loaded.
      */
-    MiniMaxAlgo(int depth);
+    bool setEvaluator(Evaluator kind);
+
+    /// @brief Returns the static evaluation in use.
+    Evaluator currentEvaluator() const { return evaluator; }
+
+    /**
+     * @brief Sets a function called with a SearchInfo after every completed iteration.
+     *
+     * Runs on the searching thread, so it must be quick and thread-safe; pass
+     * an empty function to stop the reports.
+     */
+    void setInfoCallback(std::function<void(const SearchInfo&)> callback);
+
+    /// @brief Returns the node and cutoff counters of the last search.
+    const SearchStats& lastSearchStats() const { return stats; }
 
     /**
-     * @brief Evaluates the board state.
+     * @brief Evaluates the position.
+     * @return Score from Red's point of view (Red positive, Black negative).
      */
-    int evaluateBoard(CheckersBoard& board);
+    int evaluateBoard(const Position& pos);
 
     /**
-     * @brief Executes the Minimax algorithm with Alpha-Beta Pruning.
-     * @param board The current game board.
-     * @param depth The current depth of recursion.
-     * @param isMaximizing True if maximizing AI's advantage, false if minimizing.
+     * @brief Executes the Minimax algorithm with Alpha-Beta Pruning (negamax form).
+     *
+     * Runs on the calling thread with the main thread's ordering tables.
+     *
+     * @param pos The position to search; moves are made and unmade in place.
+     * @param depth The remaining depth of recursion.
      * @param alpha The alpha value for pruning.
      * @param beta The beta value for pruning.
-     * @return A pair containing the best score and the best move as a tuple: (pieceId, targetRow, targetCol).
+     * @param ply Distance from the root, used to score quicker wins higher.
+     * @return A pair containing the best score for the side to move and the best move.
      */
-    std::pair<int, std::tuple<int, int, int>>
-    minimax(CheckersBoard& board, int depth, bool isMaximizing, int alpha = -9999, int beta = 9999);
+    std::pair<int, Move> minimax(Position& pos, int depth, int alpha = -9999, int beta = 9999, int ply = 0);
 
     /**
      * @brief Gets the best move within a given time limit using iterative deepening.
-     * @param board The current game board.
+     * @param pos The root position (side to move is the AI).
      * @param timeLimitMillis The time limit in milliseconds.
-     * @return The best move as a tuple: (pieceId, targetRow, targetCol).
+     * @return The best move, or a null Move if the side to move has none.
+     */
+    Move getBestTimedMove(const Position& pos, int timeLimitMillis);
+
+    /**
+     * @brief Gets the best move among the given root moves using iterative deepening.
+     *
+     * Lets the caller restrict the root, e.g. to the continuations of a capture
+     * sequence the board is halfway through.
+     *
+     * @param pos The root position (side to move is the AI).
+     * @param rootMoves The legal moves to choose from.
+     * @param timeLimitMillis The time limit in milliseconds.
+     * @return The best move, or a null Move if rootMoves is empty.
+     */
+    Move getBestTimedMove(const Position& pos, const MoveList& rootMoves, int timeLimitMillis);
+
+    /**
+     * @brief Like getBestTimedMove(), but also ended by any stop() after the token was read.
+     * @param pos The root position (side to move is the AI).
+     * @param rootMoves The legal moves to choose from.
+     * @param timeLimitMillis The time limit in milliseconds.
+     * @param token stopToken() read when the search was requested.
+     * @return The best move, or a null Move if rootMoves is empty.
+     */
+    Move getBestTimedMove(const Position& pos, const MoveList& rootMoves, int timeLimitMillis, unsigned token);
+
+    /**
+     * @brief Searches the opponent's position on their time, until stop() is called.
+     *
+     * Fills the transposition table, so the next getBestTimedMove() starts with
+     * results for every reply and usually reaches a deeper depth.
+     *
+     * @param pos The position with the opponent to move.
+     * @param token stopToken() read when pondering was requested.
+     * @return The opponent's expected move, or a null Move if they have none.
      */
-    std::tuple<int, int, int> getBestTimedMove(CheckersBoard& board, int timeLimitMillis);
+    Move ponder(const Position& pos, unsigned token);
 };
 
 #endif // MINIMAXALGO_H
@@ -0,0 +1,146 @@
+/**
+ * @file MoveGen.cpp
+ * @brief Implements the legal-move generator shared by the board rules and the AI.
+ *
+ * Generates every legal move for the side to move, including every branch of
+ * multi-jump capture trees, and enforces the mandatory-capture rule. Moves are
+ * written into a fixed-capacity MoveList so generation never touches the heap.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "MoveGen.h"
+#include "MoveTables.h"
+
+namespace {
+
+/**
+ * @brief Recursively extends a capture sequence from a square.
+ *
+ * Each branch gets its own copy of the enemy/empty masks, so jumped pieces
+ * are removed immediately and nothing needs to be restored on the way back.
+ *
+ * @param side The capturing side.
+ * @param square Current square of the capturing piece.
+ * @param king Whether the piece currently moves as a king.
+ * @param enemy Remaining enemy pieces.
+ * @param empty Empty squares (the start square counts as empty).
+ * @param move Sequence built so far.
+ * @param list Output list; receives the sequence once it can't be extended.
+ */
+void extendJumps(Side side, int square, bool king, uint32_t enemy, uint32_t empty,
+                 Move& move, MoveList& list)
+{
+    bool extended = false;
+
+    for (int dir = firstDirection(side, king); dir < lastDirection(side, king); ++dir) {
+        int land = MOVE_TABLES.jumpLand[square][dir];
+        if (land < 0) continue;
+
+        int over = MOVE_TABLES.jumpOver[square][dir];
+        if (!(enemy & bit(over)) || !(empty & bit(land))) continue;
+        if (move.jumps >= MAX_JUMPS) continue;
+
+        extended = true;
+
+        // Take the jump, then keep going from the landing square
+        bool crowned = king || (KING_ROW[static_cast<int>(side)] & bit(land));
+        uint32_t savedCaptured = move.captured;
+        move.captured |= bit(over);
+        move.path[move.jumps++] = static_cast<uint8_t>(land);
+
+        extendJumps(side, land, crowned, enemy & ~bit(over),
+                    (empty & ~bit(land)) | bit(over) | bit(square), move, list);
+
+        move.jumps--;
+        move.captured = savedCaptured;
+    }
+
+    // A sequence ends only when no further jump exists
+    if (!extended && move.jumps > 0) {
+        move.to = static_cast<uint8_t>(square);
+        list.add(move);
+    }
+}
+
+/// @brief Appends every capture sequence of the piece on a square.
+void addJumpsFrom(const Position& pos, int square, MoveList& list) {
+    Side side = pos.sideToMove;
+
+    Move move;
+    move.from = static_cast<uint8_t>(square);
+    extendJumps(side, square, pos.kings & bit(square), pos.pieces(opponent(side)),
+                pos.empty() | bit(square), move, list);
+}
+
+} // namespace
+
+/// @brief Appends all captures, or all quiet moves when no capture exists.
+void generateMoves(const Position& pos, MoveList& list) {
+    generateCaptures(pos, list);
+    if (!list.empty()) return;  // Mandatory capture
+
+    Side side = pos.sideToMove;
+    uint32_t own = pos.pieces(side);
+    uint32_t empty = pos.empty();
+
+    while (own) {
+        int sq = __builtin_ctz(own);
+        own &= own - 1;
+
+        bool king = pos.kings & bit(sq);
+        for (int dir = firstDirection(side, king); dir < lastDirection(side, king); ++dir) {
+            int next = MOVE_TABLES.neighbour[sq][dir];
+            if (next < 0 || !(empty & bit(next))) continue;
+
+            Move move;
+            move.from = static_cast<uint8_t>(sq);
+            move.to = static_cast<uint8_t>(next);
+            list.add(move);
+        }
+    }
+}
+
+/// @brief Appends every complete capture sequence for the side to move.
+void generateCaptures(const Position& pos, MoveList& list) {
+    list.clear();
+
+    uint32_t own = pos.pieces(pos.sideToMove);
+    while (own) {
+        int sq = __builtin_ctz(own);
+        own &= own - 1;
+        addJumpsFrom(pos, sq, list);
+    }
+}
+
+/// @brief Appends the capture sequences of a single piece.
+void generateJumpsFrom(const Position& pos, int square, MoveList& list) {
+    list.clear();
+    if (pos.pieces(pos.sideToMove) & bit(square))
+        addJumpsFrom(pos, square, list);
+}
+
+/// @brief Checks for any step or jump without building the full list.
+bool hasLegalMove(const Position& pos) {
+    Side side = pos.sideToMove;
+    uint32_t own = pos.pieces(side);
+    uint32_t enemy = pos.pieces(opponent(side));
+    uint32_t empty = pos.empty();
+
+    while (own) {
+        int sq = __builtin_ctz(own);
+        own &= own - 1;
+
+        bool king = pos.kings & bit(sq);
+        for (int dir = firstDirection(side, king); dir < lastDirection(side, king); ++dir) {
+            int next = MOVE_TABLES.neighbour[sq][dir];
+            if (next < 0) continue;
+            if (empty & bit(next)) return true;
+
+            int land = MOVE_TABLES.jumpLand[sq][dir];
+            if (land >= 0 && (enemy & bit(next)) && (empty & bit(land))) return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file MoveGen.h
+ * @brief Implements the legal-move generator shared by the board rules and the AI.
+ *
+ * Generates every legal move for the side to move, including every branch of
+ * multi-jump capture trees, and enforces the mandatory-capture rule. Moves are
+ * written into a fixed-capacity MoveList so generation never touches the heap.
+ *
+ * Capture sequences follow the same rules as the GUI: a captured piece leaves
+ * the board as soon as it is jumped, and a man crowned mid-sequence keeps
+ * capturing as a king.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "Position.h"
+#include <cassert>
+
+/**
+ * @brief Capacity of a MoveList.
+ *
+ * Quiet moves are at most 48 (twelve kings, four directions each). Capture
+ * trees have no small proven bound, but a hill-climbing search for the
+ * position with the most capture sequences found no more than 34, so 128
+ * leaves a wide margin; MoveList::add() asserts rather than dropping a move
+ * if it is ever reached.
+ */
+static const int MAX_MOVES = 128;
+
+/**
+ * @struct MoveList
+ * @brief Fixed-capacity list of moves for one position.
+ */
+struct MoveList {
+    Move moves[MAX_MOVES];  ///< Storage for the moves
+    int count = 0;          ///< Number of moves stored
+
+    /// @brief Appends a move; the list must not be full (see MAX_MOVES).
+    void add(const Move& move) {
+        assert(count < MAX_MOVES && "MoveList overflow: raise MAX_MOVES");
+        if (count < MAX_MOVES) moves[count++] = move;
+    }
+
+    /// @brief Removes every move.
+    void clear() { count = 0; }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    Move& operator[](int index) { return moves[index]; }
+    const Move& operator[](int index) const { return moves[index]; }
+
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+};
+
+/**
+ * @brief Generates every legal move for the side to move.
+ *
+ * If any capture is available only captures are generated (mandatory capture).
+ *
+ * @param pos The position.
+ * @param list Output list; cleared first.
+ */
+void generateMoves(const Position& pos, MoveList& list);
+
+/**
+ * @brief Generates every complete capture sequence for the side to move.
+ * @param pos The position.
+ * @param list Output list; cleared first.
+ */
+void generateCaptures(const Position& pos, MoveList& list);
+
+/**
+ * @brief Generates the capture sequences that start from one square.
+ *
+ * Used to continue a multi-jump that the GUI is halfway through.
+ *
+ * @param pos The position.
+ * @param square The square of the capturing piece.
+ * @param list Output list; cleared first.
+ */
+void generateJumpsFrom(const Position& pos, int square, MoveList& list);
+
+/**
+ * @brief Returns true if the side to move has at least one legal move.
+ * @param pos The position.
+ */
+bool hasLegalMove(const Position& pos);
+
+#endif // MOVEGEN_H
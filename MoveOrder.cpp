@@ -0,0 +1,117 @@
+/**
+ * @file MoveOrder.cpp
+ * @brief Implements move ordering for the alpha-beta search.
+ *
+ * Moves are tried in this order: the transposition-table (PV) move, captures
+ * (longest chains first, then most kings taken), the two killer moves of the
+ * current ply, and finally quiet moves sorted by the history table.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "MoveOrder.h"
+#include <utility>
+
+namespace {
+
+// Ordering bands; history scores always stay below KILLER_SCORE
+const int TT_MOVE_SCORE = 1000000;
+const int CAPTURE_SCORE = 500000;
+const int KILLER_SCORE = 400000;
+const int HISTORY_MAX = 300000;
+
+}
+
+/// @brief Starts with empty tables.
+MoveOrderer::MoveOrderer() {
+    clear();
+}
+
+/// @brief Empties the killer and history tables.
+void MoveOrderer::clear() {
+    for (auto& slots : killers)
+        for (Move& killer : slots)
+            killer = Move();
+
+    for (auto& side : history)
+        for (auto& from : side)
+            for (int& value : from)
+                value = 0;
+}
+
+/// @brief Killers only make sense within one search; history is kept but halved.
+void MoveOrderer::newSearch() {
+    for (auto& slots : killers)
+        for (Move& killer : slots)
+            killer = Move();
+
+    for (auto& side : history)
+        for (auto& from : side)
+            for (int& value : from)
+                value /= 2;
+}
+
+/// @brief Gives every move a score in its ordering band.
+void MoveOrderer::scoreMoves(const Position& pos, const MoveList& moves, const TTEntry* ttEntry,
+                             int ply, int scores[]) const {
+    int side = static_cast<int>(pos.sideToMove);
+    const Move* plyKillers = (ply < MAX_PLY) ? killers[ply] : nullptr;
+
+    for (int i = 0; i < moves.size(); ++i) {
+        const Move& move = moves[i];
+
+        if (ttEntry && ttEntry->matches(move)) {
+            scores[i] = TT_MOVE_SCORE;
+        } else if (move.jumps) {
+            // Longest chain first, then the one that takes the most kings
+            int kingsTaken = __builtin_popcount(move.captured & pos.kings);
+            scores[i] = CAPTURE_SCORE + move.jumps * 1000 + kingsTaken * 100;
+        } else if (plyKillers && sameMove(move, plyKillers[0])) {
+            scores[i] = KILLER_SCORE + 1;
+        } else if (plyKillers && sameMove(move, plyKillers[1])) {
+            scores[i] = KILLER_SCORE;
+        } else {
+            scores[i] = history[side][move.from][move.to];
+        }
+    }
+}
+
+/// @brief Swaps the highest-scored move among [index, size) into index.
+void MoveOrderer::pickNext(MoveList& moves, int scores[], int index) {
+    int best = index;
+    for (int i = index + 1; i < moves.size(); ++i)
+        if (scores[i] > scores[best])
+            best = i;
+
+    if (best != index) {
+        std::swap(moves[index], moves[best]);
+        std::swap(scores[index], scores[best]);
+    }
+}
+
+/// @brief Updates the killers of this ply and the history of the move.
+void MoveOrderer::recordCutoff(Side side, const Move& move, int depth, int ply) {
+    // Captures are already ordered first; only quiet moves need remembering
+    if (move.jumps) return;
+
+    if (ply < MAX_PLY && !sameMove(move, killers[ply][0])) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    int& value = history[static_cast<int>(side)][move.from][move.to];
+    value += depth * depth;
+
+    // Keep history below the killer band by halving everything when it gets large
+    if (value > HISTORY_MAX) {
+        for (auto& sideTable : history)
+            for (auto& from : sideTable)
+                for (int& entry : from)
+                    entry /= 2;
+    }
+}
+
+/// @brief Quiet moves are identified by their from and to squares.
+bool MoveOrderer::sameMove(const Move& a, const Move& b) {
+    return a.from == b.from && a.to == b.to && a.jumps == b.jumps;
+}
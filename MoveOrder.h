@@ -0,0 +1,73 @@
+/**
+ * @file MoveOrder.h
+ * @brief Implements move ordering for the alpha-beta search.
+ *
+ * Moves are tried in this order: the transposition-table (PV) move, captures
+ * (longest chains first, then most kings taken), the two killer moves of the
+ * current ply, and finally quiet moves sorted by the history table. Good
+ * ordering lets alpha-beta cut off after the first move at most nodes.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef MOVEORDER_H
+#define MOVEORDER_H
+
+#include "Position.h"
+#include "MoveGen.h"
+#include "TranspositionTable.h"
+
+/**
+ * @class MoveOrderer
+ * @brief Keeps the killer and history tables and ranks the moves of a node.
+ */
+class MoveOrderer {
+public:
+    static const int MAX_PLY = 128;  ///< Plies with their own killer slots
+    static const int KILLERS = 2;    ///< Killer moves remembered per ply
+
+    MoveOrderer();
+
+    /// @brief Forgets every killer and history entry (new game).
+    void clear();
+
+    /// @brief Starts a new search: drops killers and scales history down so old results fade.
+    void newSearch();
+
+    /**
+     * @brief Scores every move of a node for ordering.
+     * @param pos The position the moves belong to.
+     * @param moves The legal moves.
+     * @param ttEntry Transposition-table entry of the position, or nullptr.
+     * @param ply Distance from the root.
+     * @param scores Receives one ordering score per move (higher is searched first).
+     */
+    void scoreMoves(const Position& pos, const MoveList& moves, const TTEntry* ttEntry,
+                    int ply, int scores[]) const;
+
+    /**
+     * @brief Moves the best-scored remaining move to position index.
+     *
+     * Selection sort one step at a time, so a node that cuts off early never
+     * pays for sorting the moves it does not search.
+     */
+    static void pickNext(MoveList& moves, int scores[], int index);
+
+    /**
+     * @brief Records a quiet move that caused a beta cutoff.
+     * @param side Side that played the move.
+     * @param move The move.
+     * @param depth Remaining depth at the node (deeper cutoffs weigh more).
+     * @param ply Distance from the root.
+     */
+    void recordCutoff(Side side, const Move& move, int depth, int ply);
+
+private:
+    Move killers[MAX_PLY][KILLERS];                 ///< Quiet cutoff moves per ply
+    int history[2][NUM_SQUARES][NUM_SQUARES];       ///< [side][from][to] cutoff scores
+
+    /// @brief Returns true if two moves are the same move.
+    static bool sameMove(const Move& a, const Move& b);
+};
+
+#endif // MOVEORDER_H
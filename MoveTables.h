@@ -0,0 +1,132 @@
+/**
+ * @file MoveTables.h
+ * @brief Compile-time diagonal neighbour and jump tables for the 32 playable squares.
+ *
+ * Every (square, direction) pair maps to the adjacent square and to the
+ * (over, land) squares of a jump. The tables are built by constexpr functions,
+ * so move and capture queries in both the board rules and the AI reduce to a
+ * few array lookups instead of coordinate arithmetic and bounds checks.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef MOVETABLES_H
+#define MOVETABLES_H
+
+#include "Position.h"
+#include <cstdint>
+
+/**
+ * @enum Direction
+ * @brief Diagonal directions. "North" points towards row 0 (Black's promotion row).
+ */
+enum Direction : int {
+    DIR_NW = 0,     ///< (row - 1, col - 1)
+    DIR_NE = 1,     ///< (row - 1, col + 1)
+    DIR_SW = 2,     ///< (row + 1, col - 1)
+    DIR_SE = 3,     ///< (row + 1, col + 1)
+    NUM_DIRECTIONS = 4
+};
+
+/// Row and column deltas for each Direction.
+static constexpr int DIR_DELTA[NUM_DIRECTIONS][2] = { {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+
+/**
+ * @brief First direction a piece may move in.
+ *
+ * Black men move north (NW, NE), Red men move south (SW, SE), kings move both ways.
+ * Directions [firstDirection, lastDirection) are the legal ones.
+ */
+constexpr int firstDirection(Side side, bool king) {
+    return (king || side == Side::Black) ? DIR_NW : DIR_SW;
+}
+
+/// @brief One past the last direction a piece may move in (see firstDirection()).
+constexpr int lastDirection(Side side, bool king) {
+    return (king || side == Side::Red) ? NUM_DIRECTIONS : DIR_SW;
+}
+
+/// Squares on which a man of each side is crowned (Red on row 7, Black on row 0).
+static constexpr uint32_t KING_ROW[2] = { 0xF0000000u, 0x0000000Fu };
+
+static constexpr uint32_t EVEN_ROWS = 0x0F0F0F0Fu;   ///< Rows 0, 2, 4, 6 (dark squares in columns 0, 2, 4, 6)
+static constexpr uint32_t ODD_ROWS = 0xF0F0F0F0u;    ///< Rows 1, 3, 5, 7 (dark squares in columns 1, 3, 5, 7)
+static constexpr uint32_t LEFT_EDGE = 0x01010101u;   ///< Dark squares in column 0
+static constexpr uint32_t RIGHT_EDGE = 0x80808080u;  ///< Dark squares in column 7
+
+/// @brief Returns the direction pointing the other way (NW <-> SE, NE <-> SW).
+constexpr int oppositeDirection(int dir) {
+    return NUM_DIRECTIONS - 1 - dir;
+}
+
+/**
+ * @brief Moves every square of a set one diagonal step; squares that would leave the board drop out.
+ *
+ * The bitboard form of MoveTables::neighbour, for asking "which pieces can
+ * step this way" about all pieces at once.
+ */
+constexpr uint32_t shiftSquares(uint32_t squares, int dir) {
+    switch (dir) {
+    case DIR_NW: return ((squares & EVEN_ROWS & ~LEFT_EDGE) >> 5) | ((squares & ODD_ROWS) >> 4);
+    case DIR_NE: return ((squares & EVEN_ROWS) >> 4) | ((squares & ODD_ROWS & ~RIGHT_EDGE) >> 3);
+    case DIR_SW: return ((squares & EVEN_ROWS & ~LEFT_EDGE) << 3) | ((squares & ODD_ROWS) << 4);
+    default:     return ((squares & EVEN_ROWS) << 4) | ((squares & ODD_ROWS & ~RIGHT_EDGE) << 5);
+    }
+}
+
+/**
+ * @struct MoveTables
+ * @brief Per-square, per-direction geometry; -1 marks "off the board".
+ */
+struct MoveTables {
+    int8_t neighbour[NUM_SQUARES][NUM_DIRECTIONS] = {};  ///< Adjacent square
+    int8_t jumpOver[NUM_SQUARES][NUM_DIRECTIONS] = {};   ///< Square jumped over
+    int8_t jumpLand[NUM_SQUARES][NUM_DIRECTIONS] = {};   ///< Square landed on
+};
+
+/// @brief Builds the move tables at compile time.
+constexpr MoveTables buildMoveTables() {
+    MoveTables tables;
+    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
+        int row = rowOf(sq);
+        int col = colOf(sq);
+        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+            int dr = DIR_DELTA[dir][0];
+            int dc = DIR_DELTA[dir][1];
+            int next = squareOf(row + dr, col + dc);
+            int land = squareOf(row + 2 * dr, col + 2 * dc);
+
+            tables.neighbour[sq][dir] = static_cast<int8_t>(next);
+            tables.jumpOver[sq][dir] = static_cast<int8_t>(land >= 0 ? next : -1);
+            tables.jumpLand[sq][dir] = static_cast<int8_t>(land);
+        }
+    }
+    return tables;
+}
+
+/// The move tables, generated at compile time.
+inline constexpr MoveTables MOVE_TABLES = buildMoveTables();
+
+// Spot-check the generated geometry at compile time
+static_assert(MOVE_TABLES.neighbour[0][DIR_SE] == 4, "square 0 (0,0) steps to square 4 (1,1)");
+static_assert(MOVE_TABLES.neighbour[0][DIR_SW] == -1, "square 0 sits on the left edge");
+static_assert(MOVE_TABLES.jumpOver[0][DIR_SE] == 4 && MOVE_TABLES.jumpLand[0][DIR_SE] == 9,
+              "square 0 jumps over 4 onto 9 (2,2)");
+static_assert(MOVE_TABLES.neighbour[31][DIR_NW] == 27, "square 31 (7,7) steps to square 27 (6,6)");
+static_assert(MOVE_TABLES.jumpLand[27][DIR_SE] == -1, "no jump off the bottom edge");
+
+/// @brief Checks shiftSquares() against the neighbour table for every square and direction.
+constexpr bool shiftsMatchTables() {
+    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
+        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+            int next = MOVE_TABLES.neighbour[sq][dir];
+            if (shiftSquares(bit(sq), dir) != (next < 0 ? 0u : bit(next)))
+                return false;
+        }
+    }
+    return true;
+}
+
+static_assert(shiftsMatchTables(), "bitboard shifts agree with the neighbour table");
+
+#endif // MOVETABLES_H
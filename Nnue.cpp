@@ -0,0 +1,357 @@
+/**
+ * @file Nnue.cpp
+ * @brief Implements a small quantised neural-network evaluation (NNUE) for the search.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "Nnue.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if !defined(NNUE_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NNUE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const int L2_INPUTS = 2 * NNUE_HIDDEN;  // Both accumulators, clipped to bytes
+const int MAX_CHANGES = MAX_JUMPS + 2;  // Rows one move can remove or add
+
+/// @brief Feature of a piece as seen from one side.
+int featureIndex(Side view, Side side, bool king, int square) {
+    int relative = (view == Side::Red) ? square : NUM_SQUARES - 1 - square;
+    int kind = (side == view ? 0 : 2) + (king ? 1 : 0);
+    return kind * NUM_SQUARES + relative;
+}
+
+/// @brief The four piece bitboards of a position: red men, red kings, black men, black kings.
+void pieceSets(const Position& pos, uint32_t sets[4]) {
+    sets[0] = pos.red & ~pos.kings;
+    sets[1] = pos.red & pos.kings;
+    sets[2] = pos.black & ~pos.kings;
+    sets[3] = pos.black & pos.kings;
+}
+
+// Kernels: to = from + the added rows - the removed rows, over one accumulator;
+// the clipped bytes of both accumulators; and the dense layer's int32 sums
+
+void accumulateScalar(const int16_t* from, int16_t* to, const int16_t* const* added, int addCount,
+                      const int16_t* const* removed, int removeCount) {
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        int value = from[i];
+        for (int a = 0; a < addCount; ++a) value += added[a][i];
+        for (int r = 0; r < removeCount; ++r) value -= removed[r][i];
+        to[i] = static_cast<int16_t>(value);
+    }
+}
+
+void clipScalar(const int16_t* first, const int16_t* second, uint8_t* out) {
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        out[i] = static_cast<uint8_t>(std::min(127, std::max(0, static_cast<int>(first[i]))));
+        out[NNUE_HIDDEN + i] = static_cast<uint8_t>(std::min(127, std::max(0, static_cast<int>(second[i]))));
+    }
+}
+
+void denseScalar(const uint8_t* in, const int8_t* weights, const int32_t* bias, int32_t* out) {
+    for (int j = 0; j < NNUE_L2; ++j) {
+        int32_t sum = bias[j];
+        const int8_t* row = weights + j * L2_INPUTS;
+        for (int i = 0; i < L2_INPUTS; ++i)
+            sum += in[i] * row[i];
+        out[j] = sum;
+    }
+}
+
+#ifdef NNUE_X86
+
+void accumulateSse2(const int16_t* from, int16_t* to, const int16_t* const* added, int addCount,
+                    const int16_t* const* removed, int removeCount) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+        for (int a = 0; a < addCount; ++a)
+            value = _mm_add_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(added[a] + i)));
+        for (int r = 0; r < removeCount; ++r)
+            value = _mm_sub_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(removed[r] + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i), value);
+    }
+}
+
+void clipSse2(const int16_t* first, const int16_t* second, uint8_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i top = _mm_set1_epi16(127);
+    const int16_t* halves[2] = { first, second };
+    for (int h = 0; h < 2; ++h) {
+        for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(halves[h] + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(halves[h] + i + 8));
+            a = _mm_min_epi16(_mm_max_epi16(a, zero), top);
+            b = _mm_min_epi16(_mm_max_epi16(b, zero), top);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + h * NNUE_HIDDEN + i), _mm_packus_epi16(a, b));
+        }
+    }
+}
+
+void denseSse2(const uint8_t* in, const int8_t* weights, const int32_t* bias, int32_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    // Four neurons at a time, so every input is loaded and widened once per four rows
+    for (int j = 0; j < NNUE_L2; j += 4) {
+        __m128i sums[4] = { zero, zero, zero, zero };
+        for (int i = 0; i < L2_INPUTS; i += 16) {
+            // Widen to int16: inputs with zeros, weights with their sign
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i xLow = _mm_unpacklo_epi8(x, zero);
+            __m128i xHigh = _mm_unpackhi_epi8(x, zero);
+            for (int r = 0; r < 4; ++r) {
+                __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + (j + r) * L2_INPUTS + i));
+                __m128i wLow = _mm_srai_epi16(_mm_unpacklo_epi8(w, w), 8);
+                __m128i wHigh = _mm_srai_epi16(_mm_unpackhi_epi8(w, w), 8);
+                sums[r] = _mm_add_epi32(sums[r], _mm_add_epi32(_mm_madd_epi16(xLow, wLow), _mm_madd_epi16(xHigh, wHigh)));
+            }
+        }
+        // Transpose-and-add the four sums into one vector of four totals
+        __m128i t01 = _mm_add_epi32(_mm_unpacklo_epi32(sums[0], sums[1]), _mm_unpackhi_epi32(sums[0], sums[1]));
+        __m128i t23 = _mm_add_epi32(_mm_unpacklo_epi32(sums[2], sums[3]), _mm_unpackhi_epi32(sums[2], sums[3]));
+        __m128i total = _mm_add_epi32(_mm_unpacklo_epi64(t01, t23), _mm_unpackhi_epi64(t01, t23));
+        total = _mm_add_epi32(total, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bias + j)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j), total);
+    }
+}
+
+__attribute__((target("avx2")))
+void accumulateAvx2(const int16_t* from, int16_t* to, const int16_t* const* added, int addCount,
+                    const int16_t* const* removed, int removeCount) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+        for (int a = 0; a < addCount; ++a)
+            value = _mm256_add_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(added[a] + i)));
+        for (int r = 0; r < removeCount; ++r)
+            value = _mm256_sub_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(removed[r] + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(to + i), value);
+    }
+}
+
+__attribute__((target("avx2")))
+void clipAvx2(const int16_t* first, const int16_t* second, uint8_t* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i top = _mm256_set1_epi16(127);
+    const int16_t* halves[2] = { first, second };
+    for (int h = 0; h < 2; ++h) {
+        for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(halves[h] + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(halves[h] + i + 16));
+            a = _mm256_min_epi16(_mm256_max_epi16(a, zero), top);
+            b = _mm256_min_epi16(_mm256_max_epi16(b, zero), top);
+            // Packing works within 128-bit lanes; put the quarters back in order
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + h * NNUE_HIDDEN + i), packed);
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void denseAvx2(const uint8_t* in, const int8_t* weights, const int32_t* bias, int32_t* out) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    // Four neurons at a time, so every input is loaded once per four rows
+    for (int j = 0; j < NNUE_L2; j += 4) {
+        __m256i sums[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(),
+                            _mm256_setzero_si256(), _mm256_setzero_si256() };
+        for (int i = 0; i < L2_INPUTS; i += 32) {
+            // Inputs are at most 127, so the pairwise int16 sums cannot saturate
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            for (int r = 0; r < 4; ++r) {
+                __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + (j + r) * L2_INPUTS + i));
+                sums[r] = _mm256_add_epi32(sums[r], _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones));
+            }
+        }
+        // Pairwise adds leave the four totals in order, one per 32-bit slot
+        __m256i pairs = _mm256_hadd_epi32(_mm256_hadd_epi32(sums[0], sums[1]), _mm256_hadd_epi32(sums[2], sums[3]));
+        __m128i total = _mm_add_epi32(_mm256_castsi256_si128(pairs), _mm256_extracti128_si256(pairs, 1));
+        total = _mm_add_epi32(total, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bias + j)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j), total);
+    }
+}
+
+#endif
+
+/// @brief The kernels picked for this CPU.
+struct Kernels {
+    const char* name;
+    void (*accumulate)(const int16_t*, int16_t*, const int16_t* const*, int, const int16_t* const*, int);
+    void (*clip)(const int16_t*, const int16_t*, uint8_t*);
+    void (*dense)(const uint8_t*, const int8_t*, const int32_t*, int32_t*);
+};
+
+const Kernels& kernels() {
+    static const Kernels selected = [] {
+#ifdef NNUE_X86
+        if (__builtin_cpu_supports("avx2"))
+            return Kernels{ "avx2", accumulateAvx2, clipAvx2, denseAvx2 };
+        if (__builtin_cpu_supports("sse2"))
+            return Kernels{ "sse2", accumulateSse2, clipSse2, denseSse2 };
+#endif
+        return Kernels{ "scalar", accumulateScalar, clipScalar, denseScalar };
+    }();
+    return selected;
+}
+
+/// @brief Reads count values of type T from a byte buffer.
+template <typename T>
+bool readArray(const std::vector<char>& bytes, size_t& offset, std::vector<T>& values, size_t count) {
+    if (bytes.size() - offset < count * sizeof(T))
+        return false;
+    values.resize(count);
+    std::memcpy(values.data(), bytes.data() + offset, count * sizeof(T));
+    offset += count * sizeof(T);
+    return true;
+}
+
+}
+
+/// @brief Starts without a network.
+NnueNetwork::NnueNetwork() = default;
+
+/// @brief Reads and checks the weights file.
+bool NnueNetwork::load(const std::string& path) {
+    loaded = false;
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    // Header: magic, version and the layer sizes this build was compiled for
+    uint32_t header[4];
+    if (bytes.size() < 4 + sizeof(header) || std::memcmp(bytes.data(), "CKNN", 4) != 0)
+        return false;
+    std::memcpy(header, bytes.data() + 4, sizeof(header));
+    if (header[0] != 1 || header[1] != NNUE_INPUTS || header[2] != NNUE_HIDDEN || header[3] != NNUE_L2)
+        return false;
+
+    size_t offset = 4 + sizeof(header);
+    std::vector<int32_t> outputBiasValue;
+    bool complete = readArray(bytes, offset, featureWeights, NNUE_INPUTS * NNUE_HIDDEN)
+                 && readArray(bytes, offset, featureBias, NNUE_HIDDEN)
+                 && readArray(bytes, offset, l2Weights, NNUE_L2 * L2_INPUTS)
+                 && readArray(bytes, offset, l2Bias, NNUE_L2)
+                 && readArray(bytes, offset, outputWeights, NNUE_L2)
+                 && readArray(bytes, offset, outputBiasValue, 1)
+                 && offset == bytes.size();
+    if (!complete)
+        return false;
+
+    outputBias = outputBiasValue[0];
+    loaded = true;
+    return true;
+}
+
+/// @brief Returns the name of the selected kernels.
+const char* NnueNetwork::simdName() {
+    return kernels().name;
+}
+
+/// @brief Sums the bias and every piece's row, for both points of view.
+void NnueNetwork::refresh(const Position& pos, NnueAccumulator& acc) const {
+    uint32_t sets[4];
+    pieceSets(pos, sets);
+
+    for (int view = 0; view < 2; ++view) {
+        const int16_t* rows[NUM_SQUARES];
+        int count = 0;
+        for (int set = 0; set < 4; ++set) {
+            for (uint32_t squares = sets[set]; squares; squares &= squares - 1) {
+                int feature = featureIndex(static_cast<Side>(view), static_cast<Side>(set / 2), set & 1,
+                                           __builtin_ctz(squares));
+                rows[count++] = &featureWeights[feature * NNUE_HIDDEN];
+            }
+        }
+        kernels().accumulate(featureBias.data(), acc.values[view], rows, count, nullptr, 0);
+    }
+}
+
+/// @brief Adds the rows of the pieces that appeared and removes those that disappeared.
+void NnueNetwork::update(const Position& parent, const NnueAccumulator& from,
+                         const Position& child, NnueAccumulator& to) const {
+    uint32_t before[4], after[4];
+    pieceSets(parent, before);
+    pieceSets(child, after);
+
+    // More changes than one move can make: the positions are not parent and child
+    int appeared = 0, disappeared = 0;
+    for (int set = 0; set < 4; ++set) {
+        appeared += __builtin_popcount(after[set] & ~before[set]);
+        disappeared += __builtin_popcount(before[set] & ~after[set]);
+    }
+    if (appeared > MAX_CHANGES || disappeared > MAX_CHANGES) {
+        refresh(child, to);
+        return;
+    }
+
+    for (int view = 0; view < 2; ++view) {
+        const int16_t* added[MAX_CHANGES];
+        const int16_t* removed[MAX_CHANGES];
+        int addCount = 0, removeCount = 0;
+        for (int set = 0; set < 4; ++set) {
+            Side side = static_cast<Side>(set / 2);
+            bool king = set & 1;
+            for (uint32_t squares = after[set] & ~before[set]; squares; squares &= squares - 1)
+                added[addCount++] = &featureWeights[featureIndex(static_cast<Side>(view), side, king,
+                                                                 __builtin_ctz(squares)) * NNUE_HIDDEN];
+            for (uint32_t squares = before[set] & ~after[set]; squares; squares &= squares - 1)
+                removed[removeCount++] = &featureWeights[featureIndex(static_cast<Side>(view), side, king,
+                                                                      __builtin_ctz(squares)) * NNUE_HIDDEN];
+        }
+        kernels().accumulate(from.values[view], to.values[view], added, addCount, removed, removeCount);
+    }
+}
+
+/// @brief Runs the dense layers on the clipped accumulators.
+int NnueNetwork::evaluate(const NnueAccumulator& acc, Side sideToMove) const {
+    const Kernels& k = kernels();
+    int us = static_cast<int>(sideToMove);
+
+    alignas(32) uint8_t inputs[L2_INPUTS];
+    k.clip(acc.values[us], acc.values[1 - us], inputs);
+
+    int32_t sums[NNUE_L2];
+    k.dense(inputs, l2Weights.data(), l2Bias.data(), sums);
+
+    int32_t output = outputBias;
+    for (int j = 0; j < NNUE_L2; ++j)
+        output += std::min(127, std::max(0, sums[j] >> NNUE_L2_SHIFT)) * outputWeights[j];
+
+    int score = output / NNUE_OUTPUT_SCALE;
+    return std::min(NNUE_MAX_SCORE, std::max(-NNUE_MAX_SCORE, score));
+}
+
+/// @brief Refreshes a temporary accumulator and evaluates it.
+int NnueNetwork::evaluate(const Position& pos) const {
+    NnueAccumulator acc;
+    refresh(pos, acc);
+    return evaluate(acc, pos.sideToMove);
+}
+
+/// @brief Makes the root the only recorded position; its accumulators are computed on first use.
+void NnueStack::reset(const Position& root, int ply) {
+    rootPly = ply;
+    push(ply, root);
+}
+
+/// @brief Catches the accumulators up from the nearest computed ancestor, then evaluates.
+int NnueStack::evaluate(const NnueNetwork& network, int ply) {
+    int first = ply;
+    while (first > rootPly && !entries[first].computed)
+        --first;
+    if (!entries[first].computed) {
+        network.refresh(entries[first].pos, entries[first].acc);
+        entries[first].computed = true;
+    }
+
+    for (int p = first + 1; p <= ply; ++p) {
+        network.update(entries[p - 1].pos, entries[p - 1].acc, entries[p].pos, entries[p].acc);
+        entries[p].computed = true;
+    }
+    return network.evaluate(entries[ply].acc, entries[ply].pos.sideToMove);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file Nnue.h
+ * @brief Implements a small quantised neural-network evaluation (NNUE) for the search.
+ *
+ * The network sees every piece from both sides' point of view: 4 piece kinds
+ * (own man, own king, enemy man, enemy king) on 32 squares, with the board
+ * turned round for Black, so 128 inputs per side. Its first layer is an
+ * "accumulator" of NNUE_HIDDEN int16 sums per side. Only the few inputs a move
+ * changes have to be added or removed, so the search keeps one accumulator
+ * per ply and updates it from the parent instead of recomputing it.
+ *
+ * Both accumulators (side to move first) are clipped to 0..127 and fed to a
+ * dense int8 layer of NNUE_L2 neurons, clipped again, and summed into one
+ * output. The dense layer runs on AVX2 or SSE2 when the CPU has them, with a
+ * portable fallback (or always, if NNUE_NO_SIMD is defined).
+ *
+ * Weights file (little-endian):
+ *   char magic[4] = "CKNN"; uint32 version = 1; uint32 inputs, hidden, l2;
+ *   int16 featureWeights[inputs][hidden]; int16 featureBias[hidden];
+ *   int8 l2Weights[l2][2 * hidden]; int32 l2Bias[l2];
+ *   int8 outputWeights[l2]; int32 outputBias;
+ * A dense layer's int32 sums are shifted right by NNUE_L2_SHIFT before
+ * clipping, and the output is divided by NNUE_OUTPUT_SCALE to give a score in
+ * the units of the hand-written evaluation.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef NNUE_H
+#define NNUE_H
+
+#include "Position.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static const int NNUE_INPUTS = 4 * NUM_SQUARES;  ///< Inputs per point of view
+static const int NNUE_HIDDEN = 128;              ///< Accumulator width per point of view
+static const int NNUE_L2 = 32;                   ///< Neurons of the dense layer
+static const int NNUE_L2_SHIFT = 6;              ///< Right shift of the dense layer's sums
+static const int NNUE_OUTPUT_SCALE = 64;         ///< Output units per evaluation point
+static const int NNUE_MAX_SCORE = 2000;          ///< Scores are clamped to stay below any win
+
+/**
+ * @struct NnueAccumulator
+ * @brief First-layer sums of one position from both points of view.
+ */
+struct alignas(32) NnueAccumulator {
+    int16_t values[2][NNUE_HIDDEN];  ///< [Side as seen from][neuron]
+};
+
+/**
+ * @class NnueNetwork
+ * @brief The network weights and the inference code.
+ */
+class NnueNetwork {
+public:
+    NnueNetwork();
+
+    /**
+     * @brief Reads a weights file, replacing any network loaded before.
+     * @return false (and no network) if the file is missing or does not match.
+     */
+    bool load(const std::string& path);
+
+    /// @brief Returns true once a network has been loaded.
+    bool isLoaded() const { return loaded; }
+
+    /// @brief Name of the kernels in use ("avx2", "sse2" or "scalar").
+    static const char* simdName();
+
+    /// @brief Computes both accumulators of a position from scratch.
+    void refresh(const Position& pos, NnueAccumulator& acc) const;
+
+    /**
+     * @brief Derives a child's accumulators from its parent's.
+     * @param parent Position before the move, whose accumulators are in from.
+     * @param child Position after the move.
+     */
+    void update(const Position& parent, const NnueAccumulator& from,
+                const Position& child, NnueAccumulator& to) const;
+
+    /// @brief Score of a position for the side to move, given its accumulators.
+    int evaluate(const NnueAccumulator& acc, Side sideToMove) const;
+
+    /// @brief Score of a position for the side to move, computed from scratch.
+    int evaluate(const Position& pos) const;
+
+private:
+    bool loaded = false;
+    std::vector<int16_t> featureWeights;  ///< [input][hidden]
+    std::vector<int16_t> featureBias;     ///< [hidden]
+    std::vector<int8_t> l2Weights;        ///< [l2][2 * hidden]
+    std::vector<int32_t> l2Bias;          ///< [l2]
+    std::vector<int8_t> outputWeights;    ///< [l2]
+    int32_t outputBias = 0;
+};
+
+/**
+ * @class NnueStack
+ * @brief Accumulators along the line a search thread is currently on.
+ *
+ * The search records the position after each move it makes with push(); the
+ * accumulators are only brought up to date, from the nearest ply that has
+ * them, when a position is evaluated. Unmaking a move needs nothing, since
+ * the parent's entry is still there.
+ */
+class NnueStack {
+public:
+    static const int MAX_DEPTH = 129;  ///< Plies kept (MiniMaxAlgo::MAX_PLY + 1)
+
+    /// @brief Starts a new line at a root position.
+    void reset(const Position& root, int ply = 0);
+
+    /// @brief Records the position reached by a move made at ply - 1.
+    void push(int ply, const Position& pos) {
+        entries[ply].pos = pos;
+        entries[ply].computed = false;
+    }
+
+    /// @brief Evaluates the position recorded at a ply, for the side to move.
+    int evaluate(const NnueNetwork& network, int ply);
+
+private:
+    struct Entry {
+        Position pos;              ///< Position at this ply
+        NnueAccumulator acc;       ///< Its accumulators, once computed
+        bool computed = false;     ///< acc matches pos
+    };
+
+    Entry entries[MAX_DEPTH];
+    int rootPly = 0;
+};
+
+#endif // NNUE_H
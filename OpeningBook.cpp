@@ -0,0 +1,104 @@
+/**
+ * @file OpeningBook.cpp
+ * @brief Implements the binary opening book the AI plays from before it starts searching.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "OpeningBook.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+/// @brief Maps the file and checks that the header matches its size.
+bool OpeningBook::open(const std::string& path) {
+    close();
+    if (!file.map(path))
+        return false;
+
+    BookFileHeader header;
+    if (file.size() < sizeof(header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    uint64_t available = (file.size() - sizeof(header)) / sizeof(BookEntry);
+    if (std::memcmp(header.magic, "CKBK", 4) != 0 || header.version != 1 || header.entryCount > available) {
+        close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const BookEntry*>(file.data() + sizeof(header));
+    entryCount = header.entryCount;
+    return true;
+}
+
+/// @brief Unmaps the book.
+void OpeningBook::close() {
+    file.unmap();
+    entries = nullptr;
+    entryCount = 0;
+}
+
+/// @brief Binary search for the position's entries, then a weighted pick.
+Move OpeningBook::probe(const Position& pos, const MoveList& legalMoves, unsigned random) const {
+    if (!entries)
+        return Move();
+
+    uint64_t key = pos.hash();
+    const BookEntry* first = std::lower_bound(entries, entries + entryCount, key,
+        [](const BookEntry& entry, uint64_t k) { return entry.key < k; });
+
+    // Keep the book moves that are legal here; a hash collision cannot pass this
+    Move candidates[MAX_MOVES];
+    uint32_t weights[MAX_MOVES];
+    int count = 0;
+    uint32_t total = 0;
+    for (const BookEntry* entry = first; entry != entries + entryCount && entry->key == key; ++entry) {
+        if (!entry->weight)
+            continue;
+        for (const Move& move : legalMoves) {
+            if (entry->matches(move) && count < MAX_MOVES) {
+                candidates[count] = move;
+                weights[count++] = entry->weight;
+                total += entry->weight;
+                break;
+            }
+        }
+    }
+    if (!count)
+        return Move();
+
+    uint32_t pick = random % total;
+    for (int i = 0; i < count; ++i) {
+        if (pick < weights[i])
+            return candidates[i];
+        pick -= weights[i];
+    }
+    return candidates[count - 1];
+}
+
+/// @brief Writes the header and the sorted entries.
+bool OpeningBook::write(const std::string& path, std::vector<BookEntry> bookEntries) {
+    std::sort(bookEntries.begin(), bookEntries.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    BookFileHeader header;
+    header.entryCount = bookEntries.size();
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(bookEntries.data()), bookEntries.size() * sizeof(BookEntry));
+        if (!out.flush())
+            return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file OpeningBook.h
+ * @brief Implements the binary opening book the AI plays from before it starts searching.
+ *
+ * A book file is a small header followed by fixed-size entries sorted by
+ * position hash. It is memory-mapped and looked up by binary search, so a
+ * book move costs a few cache misses instead of a full search. Books are
+ * built from game records by the bookgen tool.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include "MappedFile.h"
+#include "MoveGen.h"
+#include "Position.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct BookEntry
+ * @brief One move known for one position.
+ *
+ * The move is identified by its start and end squares and the pieces it
+ * captures, which is enough to tell apart every legal move of a position.
+ */
+struct BookEntry {
+    uint64_t key = 0;       ///< Position::hash() of the position
+    uint32_t captured = 0;  ///< Squares the move captures
+    uint8_t from = 0;       ///< Start square
+    uint8_t to = 0;         ///< Final square
+    uint16_t weight = 0;    ///< How often the move should be chosen (0: never)
+
+    /// @brief Returns true if this entry describes the given move.
+    bool matches(const Move& move) const {
+        return move.from == from && move.to == to && move.captured == captured;
+    }
+};
+
+static_assert(sizeof(BookEntry) == 16, "Book entries are written to disk as-is");
+
+/**
+ * @struct BookFileHeader
+ * @brief Fixed header at the start of a book file, followed by the sorted entries.
+ */
+struct BookFileHeader {
+    char magic[4] = { 'C', 'K', 'B', 'K' };  ///< File identifier
+    uint32_t version = 1;                    ///< Format version
+    uint64_t entryCount = 0;                 ///< Number of entries
+};
+
+/**
+ * @class OpeningBook
+ * @brief Read-only view of a book file.
+ */
+class OpeningBook {
+public:
+    /**
+     * @brief Maps a book file, replacing any book opened before.
+     * @param path The book file.
+     * @return false if the file is missing or not a valid book.
+     */
+    bool open(const std::string& path);
+
+    /// @brief Closes the book.
+    void close();
+
+    /// @brief Returns true if a book is open.
+    bool isOpen() const { return entries != nullptr; }
+
+    /// @brief Number of entries in the book.
+    uint64_t size() const { return entryCount; }
+
+    /**
+     * @brief Picks a book move for a position, weighted by the book's weights.
+     * @param pos The position.
+     * @param legalMoves The moves allowed in the position; book moves outside it are ignored.
+     * @param random Any random number; picks among the weighted moves.
+     * @return The chosen move, or a null Move if the position is not in the book.
+     */
+    Move probe(const Position& pos, const MoveList& legalMoves, unsigned random) const;
+
+    /**
+     * @brief Sorts entries by position and writes them as a book file.
+     *
+     * Written to a temporary file that is then renamed, so a book being
+     * rebuilt is never left half-written.
+     *
+     * @param path Destination file.
+     * @param bookEntries The entries, in any order.
+     * @return true on success.
+     */
+    static bool write(const std::string& path, std::vector<BookEntry> bookEntries);
+
+private:
+    MappedFile file;                     ///< The mapped book
+    const BookEntry* entries = nullptr;  ///< Entries inside the mapping
+    uint64_t entryCount = 0;             ///< Number of entries
+};
+
+#endif // OPENINGBOOK_H
@@ -0,0 +1,296 @@
+/**
+ * @file Pdn.cpp
+ * @brief Reads and writes game records in Portable Draughts Notation (PDN) for the offline tools.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "Pdn.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+/// @brief Returns the result token of a credit for Black (2/1/0), or "*" if unknown.
+const char* resultText(int blackCredit) {
+    switch (blackCredit) {
+    case 2: return "1-0";
+    case 1: return "1/2-1/2";
+    case 0: return "0-1";
+    default: return "*";
+    }
+}
+
+/// @brief Returns the credit for Black (2/1/0) of a result token, or -1 if it is not one.
+int blackCredit(const std::string& token) {
+    if (token == "1-0" || token == "2-0") return 2;
+    if (token == "0-1" || token == "0-2") return 0;
+    if (token == "1/2-1/2" || token == "1-1") return 1;
+    return -1;
+}
+
+/**
+ * @class PdnReader
+ * @brief Splits PDN text into games and replays their moves.
+ */
+class PdnReader {
+public:
+    explicit PdnReader(const std::function<void(const PdnGame&)>& callback) : onGame(callback) {}
+
+    /// @brief Splits the text into tags, comments and tokens.
+    void parse(const std::string& text) {
+        size_t i = 0;
+        while (i < text.size()) {
+            char c = text[i];
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                ++i;
+            } else if (c == '[') {
+                size_t end = text.find(']', i);
+                std::string tag = text.substr(i + 1, end == std::string::npos ? std::string::npos : end - i - 1);
+                if (tag.compare(0, 3, "FEN") == 0)
+                    game.setUp = true;  // Starts from a set-up position
+                i = (end == std::string::npos) ? text.size() : end + 1;
+            } else if (c == '{') {
+                size_t end = text.find('}', i);
+                i = (end == std::string::npos) ? text.size() : end + 1;
+            } else if (c == '(') {
+                // Variations may nest
+                int depth = 0;
+                for (; i < text.size(); ++i) {
+                    if (text[i] == '(') ++depth;
+                    if (text[i] == ')' && --depth == 0) { ++i; break; }
+                }
+            } else {
+                size_t end = i;
+                while (end < text.size() && !std::isspace(static_cast<unsigned char>(text[end]))
+                       && text[end] != '{' && text[end] != '(' && text[end] != '[')
+                    ++end;
+                token(text.substr(i, end - i));
+                i = end;
+            }
+        }
+    }
+
+    /// @brief Reports a game left without a result at the end of the text.
+    void finish() {
+        if (!game.moves.empty() || game.setUp || !game.complete)
+            finishGame(-1);
+    }
+
+private:
+    const std::function<void(const PdnGame&)>& onGame;
+    PdnGame game;                         ///< The game being read
+    Position pos = Position::initial();  ///< Its current position
+
+    /// @brief Handles one movetext token.
+    void token(std::string word) {
+        int credit = blackCredit(word);
+        if (credit >= 0 || word == "*") {
+            finishGame(credit);
+            return;
+        }
+
+        // Drop a move number ("12." or "12...") glued to the move
+        size_t dot = word.find_last_of('.');
+        if (dot != std::string::npos)
+            word = word.substr(dot + 1);
+        while (!word.empty() && !std::isdigit(static_cast<unsigned char>(word.back())))
+            word.pop_back();  // Annotations such as "!" or "?"
+        if (word.empty() || game.setUp || !game.complete)
+            return;
+
+        Move move;
+        if (!parsePdnMove(word, pos, move)) {
+            game.complete = false;
+            return;
+        }
+        game.moves.push_back(move);
+        pos.applyMove(move);
+    }
+
+    /// @brief Hands the game just read on and starts a new one.
+    void finishGame(int credit) {
+        game.blackCredit = credit;
+        onGame(game);
+
+        game = PdnGame();
+        pos = Position::initial();
+    }
+};
+
+}
+
+/// @brief Converts a PDN square number (1-32) to a square index.
+int squareFromPdn(int number) {
+    int fromTop = (number - 1) / 4;  // 0 is Black's back rank, row 7
+    int inRow = (number - 1) % 4;
+    int row = 7 - fromTop;
+    int col = (fromTop % 2 == 0) ? 2 * inRow + 1 : 2 * inRow;
+    return squareOf(row, col);
+}
+
+/// @brief Inverse of squareFromPdn().
+int pdnFromSquare(int square) {
+    int fromTop = 7 - rowOf(square);
+    int col = colOf(square);
+    int inRow = (fromTop % 2 == 0) ? (col - 1) / 2 : col / 2;
+    return fromTop * 4 + inRow + 1;
+}
+
+/// @brief Steps as "from-to", captures with every landing square.
+std::string pdnMoveText(const Move& move) {
+    std::string text = std::to_string(pdnFromSquare(move.from));
+    if (move.jumps == 0)
+        return text + "-" + std::to_string(pdnFromSquare(move.to));
+    for (int i = 0; i < move.jumps; ++i)
+        text += "x" + std::to_string(pdnFromSquare(move.path[i]));
+    return text;
+}
+
+/// @brief Tags, numbered moves and the result, wrapped at about 80 columns.
+std::string pdnGameText(const std::vector<std::pair<std::string, std::string>>& tags,
+                        const std::vector<Move>& moves, int blackCredit) {
+    std::string text;
+    for (const auto& tag : tags)
+        text += "[" + tag.first + " \"" + tag.second + "\"]\n";
+    text += "[Result \"" + std::string(resultText(blackCredit)) + "\"]\n";
+
+    std::string line;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        std::string word = (i % 2 == 0) ? std::to_string(i / 2 + 1) + ". " : "";
+        word += pdnMoveText(moves[i]);
+        if (line.size() + word.size() + 1 > 80) {
+            text += line + "\n";
+            line.clear();
+        }
+        line += (line.empty() ? "" : " ") + word;
+    }
+    std::string result = resultText(blackCredit);
+    if (line.size() + result.size() + 1 > 80) {
+        text += line + "\n";
+        line.clear();
+    }
+    text += line + (line.empty() ? "" : " ") + result + "\n\n";
+    return text;
+}
+
+/// @brief Side to move, then each side's squares with "K" before kings.
+bool parsePdnFen(const std::string& text, Position& pos) {
+    std::string fen = text;
+    fen.erase(std::remove_if(fen.begin(), fen.end(), [](char c) {
+        return std::isspace(static_cast<unsigned char>(c)) || c == '"' || c == '.';
+    }), fen.end());
+    std::stringstream in(fen);
+    std::string field;
+    if (!std::getline(in, field, ':') || (field != "W" && field != "B"))
+        return false;
+
+    Position result;
+    result.sideToMove = (field == "W") ? Side::Red : Side::Black;
+    while (std::getline(in, field, ':')) {
+        if (field.empty() || (field[0] != 'W' && field[0] != 'B'))
+            return false;
+        Side side = (field[0] == 'W') ? Side::Red : Side::Black;
+
+        std::stringstream squares(field.substr(1));
+        std::string item;
+        while (std::getline(squares, item, ',')) {
+            if (item.empty())
+                continue;
+            bool king = (item[0] == 'K');
+            if (king)
+                item.erase(0, 1);
+            size_t dash = item.find('-');
+            int first = std::atoi(item.c_str());
+            int last = (dash == std::string::npos) ? first : std::atoi(item.c_str() + dash + 1);
+            if (first < 1 || last > 32 || first > last)
+                return false;
+            for (int n = first; n <= last; ++n) {
+                if (result.occupied() & bit(squareFromPdn(n)))
+                    return false;
+                result.setPiece(squareFromPdn(n), side, king);
+            }
+        }
+    }
+    pos = result;
+    return true;
+}
+
+/// @brief Side to move, then each side's squares in PDN order.
+std::string pdnFenText(const Position& pos) {
+    std::string text = (pos.sideToMove == Side::Red) ? "W" : "B";
+    for (Side side : { Side::Red, Side::Black }) {
+        text += (side == Side::Red) ? ":W" : ":B";
+        bool first = true;
+        for (int n = 1; n <= 32; ++n) {
+            int square = squareFromPdn(n);
+            if (!(pos.pieces(side) & bit(square)))
+                continue;
+            text += (first ? "" : ",") + std::string((pos.kings & bit(square)) ? "K" : "") + std::to_string(n);
+            first = false;
+        }
+    }
+    return text;
+}
+
+/// @brief Matches the squares of a PDN move against the legal moves.
+bool parsePdnMove(const std::string& text, const Position& pos, Move& result) {
+    std::vector<int> squares;
+    std::string number;
+    for (char c : text + "-") {
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            number += c;
+        } else if (c == '-' || c == 'x' || c == 'X') {
+            int n = number.empty() ? 0 : std::atoi(number.c_str());
+            if (n < 1 || n > 32)
+                return false;
+            squares.push_back(squareFromPdn(n));
+            number.clear();
+        } else {
+            return false;
+        }
+    }
+    if (squares.size() < 2)
+        return false;
+
+    MoveList moves;
+    generateMoves(pos, moves);
+    for (const Move& move : moves) {
+        if (move.from != squares.front() || move.to != squares.back())
+            continue;
+
+        // Intermediate landings, when given, must match the capture path
+        bool samePath = true;
+        if (squares.size() > 2) {
+            samePath = static_cast<int>(squares.size()) - 1 == move.jumps;
+            for (int i = 0; samePath && i < move.jumps; ++i)
+                samePath = move.path[i] == squares[i + 1];
+        }
+        if (samePath) {
+            result = move;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Parses the games of a PDN text one after another.
+void readPdnGames(const std::string& text, const std::function<void(const PdnGame&)>& onGame) {
+    PdnReader reader(onGame);
+    reader.parse(text);
+    reader.finish();
+}
+
+/// @brief Loads a PDN file and parses its games.
+bool readPdnFile(const std::string& path, const std::function<void(const PdnGame&)>& onGame) {
+    std::ifstream in(path);
+    if (!in)
+        return false;
+    std::stringstream text;
+    text << in.rdbuf();
+    readPdnGames(text.str(), onGame);
+    return true;
+}
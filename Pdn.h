@@ -0,0 +1,79 @@
+/**
+ * @file Pdn.h
+ * @brief Reads and writes game records in Portable Draughts Notation (PDN) for the offline tools.
+ *
+ * PDN squares are numbered 1-32 with Black (the side that moves first) on
+ * 1-12. A result of "1-0" is a win for Black and "0-1" a win for White, which
+ * is Red here. Tags other than [FEN], comments, variations, move numbers and
+ * annotations are skipped.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef PDN_H
+#define PDN_H
+
+#include "MoveGen.h"
+#include "Position.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct PdnGame
+ * @brief One game read from a PDN file.
+ */
+struct PdnGame {
+    std::vector<Move> moves;  ///< Moves from the starting position, up to the first illegal one
+    int blackCredit = -1;     ///< 2 if Black won, 1 for a draw, 0 if Red won, -1 if unknown
+    bool setUp = false;       ///< Starts from a [FEN] position; moves is then empty
+    bool complete = true;     ///< false if an illegal move cut the game short
+};
+
+/// @brief Converts a PDN square number (1-32) to a square index.
+int squareFromPdn(int number);
+
+/// @brief Converts a square index to its PDN square number (1-32).
+int pdnFromSquare(int square);
+
+/// @brief Writes a move in PDN, e.g. "11-15" or "6x15x22" (every landing of a capture).
+std::string pdnMoveText(const Move& move);
+
+/**
+ * @brief Writes a whole game from the starting position.
+ * @param tags Tag pairs written before the moves, e.g. {"Event", "Match"}.
+ * @param blackCredit 2 if Black won, 1 for a draw, 0 if Red won, -1 if unknown.
+ * @return The game's PDN text, ending in a blank line.
+ */
+std::string pdnGameText(const std::vector<std::pair<std::string, std::string>>& tags,
+                        const std::vector<Move>& moves, int blackCredit);
+
+/**
+ * @brief Reads a PDN FEN such as "B:W18,24,K27:B12,K16" (ranges like "1-12" allowed).
+ * @return false if the text is not a FEN.
+ */
+bool parsePdnFen(const std::string& text, Position& pos);
+
+/// @brief Writes a position as a PDN FEN.
+std::string pdnFenText(const Position& pos);
+
+/**
+ * @brief Finds the legal move a PDN move such as "11-15", "15x24" or "6x15x22" stands for.
+ * @return false if the text is not a move or no legal move matches.
+ */
+bool parsePdnMove(const std::string& text, const Position& pos, Move& result);
+
+/**
+ * @brief Reads every game of a PDN text.
+ * @param onGame Called once for each game, in order.
+ */
+void readPdnGames(const std::string& text, const std::function<void(const PdnGame&)>& onGame);
+
+/**
+ * @brief Reads every game of a PDN file.
+ * @return false if the file cannot be read.
+ */
+bool readPdnFile(const std::string& path, const std::function<void(const PdnGame&)>& onGame);
+
+#endif // PDN_H
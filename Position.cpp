@@ -0,0 +1,147 @@
+/**
+ * @file Position.cpp
+ * @brief Implements the compact, Qt-free board representation used by the AI search.
+ *
+ * A Position stores the 32 playable squares as bitboards (red men/kings, black men/kings)
+ * plus the side to move. It is converted to and from CheckersBoard only at the root of
+ * the search, so the search itself never touches QGraphicsScene items.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "Position.h"
+#include "EvalTables.h"
+#include "MoveTables.h"
+#include "Zobrist.h"
+
+namespace {
+
+/// @brief Returns true if a man of this side has reached its promotion row.
+bool reachesKingRow(Side side, int square) {
+    return KING_ROW[static_cast<int>(side)] & bit(square);
+}
+
+} // namespace
+
+/// @brief Builds the standard starting position: Red on rows 0-2, Black on rows 5-7.
+Position Position::initial() {
+    Position pos;
+    pos.red = 0x00000FFFu;      // squares 0..11
+    pos.black = 0xFFF00000u;    // squares 20..31
+    pos.kings = 0;
+    pos.sideToMove = Side::Black;
+    pos.key = pos.computeKey();
+    pos.psqt = pos.computePsqt();
+    return pos;
+}
+
+/// @brief Folds the side to move into the piece key.
+uint64_t Position::hash() const {
+    return (sideToMove == Side::Black) ? key ^ ZOBRIST.blackToMove : key;
+}
+
+/// @brief XORs together the key of every piece on the board.
+uint64_t Position::computeKey() const {
+    uint64_t result = 0;
+    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
+        if (red & bit(sq)) result ^= pieceKey(Side::Red, kings & bit(sq), sq);
+        if (black & bit(sq)) result ^= pieceKey(Side::Black, kings & bit(sq), sq);
+    }
+    return result;
+}
+
+/// @brief Adds up the piece-square value of every piece on the board.
+int Position::computePsqt() const {
+    int result = 0;
+    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
+        if (red & bit(sq)) result += pieceSquareValue(Side::Red, kings & bit(sq), sq);
+        if (black & bit(sq)) result += pieceSquareValue(Side::Black, kings & bit(sq), sq);
+    }
+    return result;
+}
+
+/// @brief Places a piece of the given side and rank on a square.
+void Position::setPiece(int square, Side side, bool king) {
+    uint32_t mask = bit(square);
+    if (side == Side::Red) red |= mask;
+    else black |= mask;
+    if (king) kings |= mask;
+    key ^= pieceKey(side, king, square);
+    psqt += pieceSquareValue(side, king, square);
+}
+
+/// @brief Applies a move when it will never be taken back.
+void Position::applyMove(const Move& move) {
+    MoveUndo undo;
+    makeMove(move, undo);
+}
+
+/// @brief Moves the piece, removes captured pieces, promotes, and passes the turn.
+void Position::makeMove(const Move& move, MoveUndo& undo) {
+    uint32_t fromMask = bit(move.from);
+    uint32_t toMask = bit(move.to);
+
+    undo.wasKing = kings & fromMask;
+    undo.capturedKings = kings & move.captured;
+    undo.key = key;
+    undo.psqt = psqt;
+
+    // Remove every captured piece from the key and the piece-square sum
+    Side enemy = opponent(sideToMove);
+    for (uint32_t rest = move.captured; rest; rest &= rest - 1) {
+        int sq = __builtin_ctz(rest);
+        bool capturedKing = undo.capturedKings & bit(sq);
+        key ^= pieceKey(enemy, capturedKing, sq);
+        psqt -= pieceSquareValue(enemy, capturedKing, sq);
+    }
+
+    if (sideToMove == Side::Red) {
+        red = (red & ~fromMask) | toMask;
+        black &= ~move.captured;
+    } else {
+        black = (black & ~fromMask) | toMask;
+        red &= ~move.captured;
+    }
+
+    // A man crowned on any hop stays a king for the rest of the sequence
+    bool promoted = reachesKingRow(sideToMove, move.to);
+    for (int i = 0; i < move.jumps && !promoted; ++i)
+        promoted = reachesKingRow(sideToMove, move.path[i]);
+
+    kings &= ~(fromMask | move.captured);
+    if (undo.wasKing || promoted)
+        kings |= toMask;
+
+    // Move the piece in the key and the piece-square sum
+    key ^= pieceKey(sideToMove, undo.wasKing, move.from);
+    key ^= pieceKey(sideToMove, undo.wasKing || promoted, move.to);
+    psqt += pieceSquareValue(sideToMove, undo.wasKing || promoted, move.to)
+          - pieceSquareValue(sideToMove, undo.wasKing, move.from);
+
+    sideToMove = opponent(sideToMove);
+}
+
+/// @brief Restores the position from before makeMove().
+void Position::unmakeMove(const Move& move, const MoveUndo& undo) {
+    uint32_t fromMask = bit(move.from);
+    uint32_t toMask = bit(move.to);
+
+    sideToMove = opponent(sideToMove);
+
+    // Clear the destination first: a king can end a capture loop on its start square
+    if (sideToMove == Side::Red) {
+        red = (red & ~toMask) | fromMask;
+        black |= move.captured;
+    } else {
+        black = (black & ~toMask) | fromMask;
+        red |= move.captured;
+    }
+
+    kings &= ~toMask;
+    if (undo.wasKing)
+        kings |= fromMask;
+    kings |= undo.capturedKings;
+
+    key = undo.key;
+    psqt = undo.psqt;
+}
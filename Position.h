@@ -0,0 +1,155 @@
+/**
+ * @file Position.h
+ * @brief Implements the compact, Qt-free board representation used by the AI search.
+ *
+ * A Position stores the 32 playable squares as bitboards (red men/kings, black men/kings)
+ * plus the side to move. It is converted to and from CheckersBoard only at the root of
+ * the search, so the search itself never touches QGraphicsScene items.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+
+/**
+ * @enum Side
+ * @brief The two sides of a checkers game as seen by the search.
+ */
+enum class Side : uint8_t {
+    Red = 0,    ///< Starts on rows 0-2 and moves towards row 7 (AI side)
+    Black = 1   ///< Starts on rows 5-7 and moves towards row 0 (moves first)
+};
+
+/// @brief Returns the opposing side.
+constexpr Side opponent(Side side) {
+    return side == Side::Red ? Side::Black : Side::Red;
+}
+
+static const int NUM_SQUARES = 32;           ///< Playable (dark) squares on an 8x8 board
+static const uint8_t NO_SQUARE = 0xFF;       ///< Marker for "no square"
+static const int MAX_JUMPS = 12;             ///< Upper bound on captures in one move
+
+/**
+ * @brief Maps a (row, col) board coordinate to a square index 0..31.
+ *
+ * Dark squares are those where (row + col) is even. Squares are numbered row by row,
+ * four per row, starting from row 0.
+ *
+ * @return Square index, or -1 if the coordinate is off-board or a light square.
+ */
+constexpr int squareOf(int row, int col) {
+    return (row < 0 || row > 7 || col < 0 || col > 7 || ((row + col) & 1)) ? -1 : row * 4 + col / 2;
+}
+
+/// @brief Returns the board row (0..7) of a square index.
+constexpr int rowOf(int square) {
+    return square >> 2;
+}
+
+/// @brief Returns the board column (0..7) of a square index.
+constexpr int colOf(int square) {
+    return 2 * (square & 3) + ((square >> 2) & 1);
+}
+
+/// @brief Returns the single-bit mask for a square index.
+constexpr uint32_t bit(int square) {
+    return 1u << square;
+}
+
+/**
+ * @struct Move
+ * @brief A complete move for one side: a single step or a whole capture sequence.
+ */
+struct Move {
+    uint8_t from = NO_SQUARE;        ///< Square the piece starts on
+    uint8_t to = NO_SQUARE;          ///< Square the piece ends on
+    uint8_t jumps = 0;               ///< Number of pieces captured (0 for a quiet move)
+    uint8_t path[MAX_JUMPS] = {};    ///< Landing square of every hop (path[jumps - 1] == to)
+    uint32_t captured = 0;           ///< Bitboard of every captured square
+
+    /// @brief Returns true if this is the "no move" placeholder.
+    bool isNull() const { return from == NO_SQUARE; }
+
+    /// @brief Returns the landing square of the first hop (what the GUI moves to first).
+    uint8_t firstLanding() const { return jumps ? path[0] : to; }
+};
+
+/**
+ * @struct MoveUndo
+ * @brief Stores what a Position needs to take back one complete move.
+ *
+ * The search counterpart of MoveRecord, but covering a whole capture sequence.
+ */
+struct MoveUndo {
+    uint32_t capturedKings = 0;      ///< Which of the captured pieces were kings
+    bool wasKing = false;            ///< Whether the moving piece was a king before the move
+    uint64_t key = 0;                ///< Zobrist piece key before the move
+    int psqt = 0;                    ///< Piece-square sum before the move
+};
+
+/**
+ * @struct Position
+ * @brief Bitboard snapshot of a checkers position.
+ */
+struct Position {
+    uint32_t red = 0;                ///< Red pieces (men and kings)
+    uint32_t black = 0;              ///< Black pieces (men and kings)
+    uint32_t kings = 0;              ///< Kings of either colour
+    Side sideToMove = Side::Black;   ///< Side whose turn it is
+    uint64_t key = 0;                ///< Zobrist key of the pieces (see Zobrist.h), kept up to date incrementally
+    int psqt = 0;                    ///< Sum of the piece-square values (see EvalTables.h), Red positive, kept up to date incrementally
+
+    /// @brief Returns the standard starting position (Black to move).
+    static Position initial();
+
+    /// @brief Returns the Zobrist hash of the position, including the side to move.
+    uint64_t hash() const;
+
+    /// @brief Recomputes the Zobrist piece key from scratch (after editing bitboards directly).
+    uint64_t computeKey() const;
+
+    /// @brief Recomputes the piece-square sum from scratch (after editing bitboards directly).
+    int computePsqt() const;
+
+    /// @brief Returns the pieces belonging to a side.
+    uint32_t pieces(Side side) const { return side == Side::Red ? red : black; }
+
+    /// @brief Returns every occupied square.
+    uint32_t occupied() const { return red | black; }
+
+    /// @brief Returns every empty playable square.
+    uint32_t empty() const { return ~(red | black); }
+
+    /**
+     * @brief Places a piece on a square.
+     * @param square Square index 0..31.
+     * @param side Owner of the piece.
+     * @param king True if the piece is a king.
+     */
+    void setPiece(int square, Side side, bool king);
+
+    /**
+     * @brief Applies a move for the side to move and passes the turn.
+     * @param move A legal move (see MoveGen.h).
+     */
+    void applyMove(const Move& move);
+
+    /**
+     * @brief Applies a move in place, recording what is needed to take it back.
+     * @param move A legal move (see MoveGen.h).
+     * @param undo Receives the undo record.
+     */
+    void makeMove(const Move& move, MoveUndo& undo);
+
+    /**
+     * @brief Takes back a move made with makeMove().
+     * @param move The move that was made.
+     * @param undo The record filled in by makeMove().
+     */
+    void unmakeMove(const Move& move, const MoveUndo& undo);
+};
+
+#endif // POSITION_H
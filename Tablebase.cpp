@@ -0,0 +1,363 @@
+/**
+ * @file Tablebase.cpp
+ * @brief Implements the endgame tablebase layout shared by the generator and the search.
+ *
+ * Index layout of a table (our men, our kings, their men, their kings):
+ *   - our men are ranked among squares 4..31 (a man of ours never stands on row 0),
+ *   - their men among squares 0..27,
+ *   - our kings among the squares the men leave free,
+ *   - their kings among the squares left after that.
+ * Men of both sides may overlap in this scheme; such indices are invalid and
+ * never probed.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "Tablebase.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+const int MEN_SQUARES = 28;  // Squares a man can stand on
+
+// Binomial coefficients C(n, k) for n <= 32, k <= TB_MAX_PIECES
+struct Binomials {
+    uint64_t c[NUM_SQUARES + 1][TB_MAX_PIECES + 1] = {};
+
+    constexpr Binomials() {
+        for (int n = 0; n <= NUM_SQUARES; ++n) {
+            c[n][0] = 1;
+            for (int k = 1; k <= TB_MAX_PIECES; ++k)
+                c[n][k] = (n == 0) ? 0 : c[n - 1][k - 1] + c[n - 1][k];
+        }
+    }
+};
+
+constexpr Binomials BINOMIALS;
+
+uint64_t choose(int n, int k) {
+    return (n < 0 || k < 0 || k > n) ? 0 : BINOMIALS.c[n][k];
+}
+
+// Rotates a bitboard by 180 degrees (square s becomes 31 - s)
+uint32_t flip(uint32_t squares) {
+    uint32_t result = 0;
+    while (squares) {
+        int sq = __builtin_ctz(squares);
+        squares &= squares - 1;
+        result |= bit(31 - sq);
+    }
+    return result;
+}
+
+// Colex rank of a set of positions 0..n-1
+uint64_t rankSet(uint32_t positions) {
+    uint64_t rank = 0;
+    int i = 1;
+    while (positions) {
+        int p = __builtin_ctz(positions);
+        positions &= positions - 1;
+        rank += choose(p, i++);
+    }
+    return rank;
+}
+
+// Inverse of rankSet for a set of k positions
+uint32_t unrankSet(uint64_t rank, int k) {
+    uint32_t positions = 0;
+    for (int i = k; i >= 1; --i) {
+        int p = i - 1;
+        while (choose(p + 1, i) <= rank)
+            ++p;
+        rank -= choose(p, i);
+        positions |= bit(p);
+    }
+    return positions;
+}
+
+// Maps squares onto positions among the squares of a domain (gather)
+uint32_t compress(uint32_t squares, uint32_t domain) {
+    uint32_t result = 0;
+    int p = 0;
+    while (domain) {
+        int sq = __builtin_ctz(domain);
+        domain &= domain - 1;
+        if (squares & bit(sq))
+            result |= bit(p);
+        ++p;
+    }
+    return result;
+}
+
+// Maps positions among the squares of a domain back onto squares (scatter)
+uint32_t expand(uint32_t positions, uint32_t domain) {
+    uint32_t result = 0;
+    int p = 0;
+    while (domain) {
+        int sq = __builtin_ctz(domain);
+        domain &= domain - 1;
+        if (positions & bit(p))
+            result |= bit(sq);
+        ++p;
+    }
+    return result;
+}
+
+const uint32_t OUR_MEN_DOMAIN = 0xFFFFFFF0u;    // Black men: never on row 0
+const uint32_t THEIR_MEN_DOMAIN = 0x0FFFFFFFu;  // Red men: never on row 7
+
+void writeVarint(uint32_t value, std::vector<uint8_t>& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+}
+
+/// @brief Product of the four group sizes.
+uint64_t MaterialSignature::size() const {
+    int free = NUM_SQUARES - ourMen - theirMen;
+    return choose(MEN_SQUARES, ourMen) * choose(MEN_SQUARES, theirMen)
+         * choose(free, ourKings) * choose(free - ourKings, theirKings);
+}
+
+/// @brief Builds "tb_<ourMen><ourKings>_<theirMen><theirKings>.ctb".
+std::string MaterialSignature::fileName() const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "tb_%d%d_%d%d.ctb", ourMen, ourKings, theirMen, theirKings);
+    return name;
+}
+
+/// @brief Rotates the board and swaps colours when Red is to move.
+Position tbCanonical(const Position& pos) {
+    if (pos.sideToMove == Side::Black)
+        return pos;
+
+    Position result;
+    result.black = flip(pos.red);
+    result.red = flip(pos.black);
+    result.kings = flip(pos.kings);
+    result.sideToMove = Side::Black;
+    result.key = result.computeKey();
+    result.psqt = result.computePsqt();
+    return result;
+}
+
+/// @brief Counts men and kings of each side.
+MaterialSignature tbSignature(const Position& canonical) {
+    MaterialSignature sig;
+    sig.ourMen = static_cast<uint8_t>(__builtin_popcount(canonical.black & ~canonical.kings));
+    sig.ourKings = static_cast<uint8_t>(__builtin_popcount(canonical.black & canonical.kings));
+    sig.theirMen = static_cast<uint8_t>(__builtin_popcount(canonical.red & ~canonical.kings));
+    sig.theirKings = static_cast<uint8_t>(__builtin_popcount(canonical.red & canonical.kings));
+    return sig;
+}
+
+/// @brief Mixed-radix combination of the four group ranks.
+uint64_t tbIndex(const Position& canonical, const MaterialSignature& sig) {
+    uint32_t ourMen = canonical.black & ~canonical.kings;
+    uint32_t theirMen = canonical.red & ~canonical.kings;
+    uint32_t ourKings = canonical.black & canonical.kings;
+    uint32_t theirKings = canonical.red & canonical.kings;
+
+    uint32_t kingDomain = ~(ourMen | theirMen);
+    uint32_t theirKingDomain = kingDomain & ~ourKings;
+    int free = NUM_SQUARES - sig.ourMen - sig.theirMen;
+
+    uint64_t index = rankSet(compress(ourMen, OUR_MEN_DOMAIN));
+    index = index * choose(MEN_SQUARES, sig.theirMen) + rankSet(compress(theirMen, THEIR_MEN_DOMAIN));
+    index = index * choose(free, sig.ourKings) + rankSet(compress(ourKings, kingDomain));
+    index = index * choose(free - sig.ourKings, sig.theirKings) + rankSet(compress(theirKings, theirKingDomain));
+    return index;
+}
+
+/// @brief Splits the index back into group ranks and places the pieces.
+bool tbPosition(const MaterialSignature& sig, uint64_t index, Position& pos) {
+    int free = NUM_SQUARES - sig.ourMen - sig.theirMen;
+    uint64_t theirKingCount = choose(free - sig.ourKings, sig.theirKings);
+    uint64_t ourKingCount = choose(free, sig.ourKings);
+    uint64_t theirMenCount = choose(MEN_SQUARES, sig.theirMen);
+
+    uint64_t theirKingRank = index % theirKingCount;
+    index /= theirKingCount;
+    uint64_t ourKingRank = index % ourKingCount;
+    index /= ourKingCount;
+    uint64_t theirMenRank = index % theirMenCount;
+    uint64_t ourMenRank = index / theirMenCount;
+
+    uint32_t ourMen = expand(unrankSet(ourMenRank, sig.ourMen), OUR_MEN_DOMAIN);
+    uint32_t theirMen = expand(unrankSet(theirMenRank, sig.theirMen), THEIR_MEN_DOMAIN);
+    if (ourMen & theirMen)
+        return false;
+
+    uint32_t kingDomain = ~(ourMen | theirMen);
+    uint32_t ourKings = expand(unrankSet(ourKingRank, sig.ourKings), kingDomain);
+    uint32_t theirKings = expand(unrankSet(theirKingRank, sig.theirKings), kingDomain & ~ourKings);
+
+    pos = Position();
+    pos.black = ourMen | ourKings;
+    pos.red = theirMen | theirKings;
+    pos.kings = ourKings | theirKings;
+    pos.sideToMove = Side::Black;
+    pos.key = pos.computeKey();
+    pos.psqt = pos.computePsqt();
+    return true;
+}
+
+/// @brief Enumerates signatures in dependency order.
+std::vector<MaterialSignature> tbSignatures(int maxPieces) {
+    std::vector<MaterialSignature> result;
+    maxPieces = std::min(maxPieces, TB_MAX_PIECES);
+
+    for (int pieces = 2; pieces <= maxPieces; ++pieces) {
+        for (int men = 0; men <= pieces; ++men) {
+            for (int ourPieces = 1; ourPieces < pieces; ++ourPieces) {
+                int theirPieces = pieces - ourPieces;
+                for (int ourMen = 0; ourMen <= std::min(ourPieces, men); ++ourMen) {
+                    int theirMen = men - ourMen;
+                    if (theirMen < 0 || theirMen > theirPieces)
+                        continue;
+
+                    MaterialSignature sig;
+                    sig.ourMen = static_cast<uint8_t>(ourMen);
+                    sig.ourKings = static_cast<uint8_t>(ourPieces - ourMen);
+                    sig.theirMen = static_cast<uint8_t>(theirMen);
+                    sig.theirKings = static_cast<uint8_t>(theirPieces - theirMen);
+                    result.push_back(sig);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/// @brief Writes (value, run length) pairs, treating invalid entries as wildcards.
+void tbCompressBlock(const uint8_t* values, uint32_t count, std::vector<uint8_t>& out) {
+    uint32_t i = 0;
+    while (i < count) {
+        // A run starts at the first real value; leading wildcards join it
+        uint32_t start = i;
+        while (i < count && values[i] == TB_INVALID)
+            ++i;
+        uint8_t value = (i < count) ? values[i] : uint8_t(TB_DRAW);
+
+        while (i < count && (values[i] == value || values[i] == TB_INVALID))
+            ++i;
+
+        out.push_back(value);
+        writeVarint(i - start, out);
+    }
+}
+
+/// @brief Expands (value, run length) pairs.
+bool tbDecompressBlock(const uint8_t* data, size_t size, uint8_t* values, uint32_t count) {
+    size_t pos = 0;
+    uint32_t filled = 0;
+    while (filled < count) {
+        if (pos >= size)
+            return false;
+        uint8_t value = data[pos++];
+
+        uint32_t run = 0;
+        int shift = 0;
+        while (true) {
+            if (pos >= size || shift > 28)
+                return false;
+            uint8_t byte = data[pos++];
+            run |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                break;
+            shift += 7;
+        }
+
+        if (run > count - filled)
+            return false;
+        std::memset(values + filled, value, run);
+        filled += run;
+    }
+    return true;
+}
+
+/// @brief Compresses every block, then writes header, offsets and data.
+bool tbWriteFile(const std::string& path, const MaterialSignature& sig,
+                 const std::vector<uint8_t>& values, bool dtw) {
+    TBFileHeader header;
+    header.dtw = dtw ? 1 : 0;
+    header.signature[0] = sig.ourMen;
+    header.signature[1] = sig.ourKings;
+    header.signature[2] = sig.theirMen;
+    header.signature[3] = sig.theirKings;
+    header.positions = values.size();
+    header.blockCount = (values.size() + TB_BLOCK_SIZE - 1) / TB_BLOCK_SIZE;
+
+    std::vector<uint64_t> offsets;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> block(TB_BLOCK_SIZE);
+    for (uint64_t b = 0; b < header.blockCount; ++b) {
+        uint64_t first = b * TB_BLOCK_SIZE;
+        uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(TB_BLOCK_SIZE, values.size() - first));
+        for (uint32_t i = 0; i < count; ++i)
+            block[i] = dtw ? values[first + i] : dtwToWdl(values[first + i]);
+
+        offsets.push_back(data.size());
+        tbCompressBlock(block.data(), count, data);
+    }
+    offsets.push_back(data.size());
+
+    // Write next to the destination and rename, so a crash never leaves half a table
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file.flush())
+            return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/// @brief Validates the header and decompresses every block.
+bool tbReadFile(const std::string& path, const MaterialSignature& sig,
+                std::vector<uint8_t>& values, bool& dtw) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    TBFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+    if (std::memcmp(header.magic, "CKTB", 4) != 0 || header.version != 1
+        || header.signature[0] != sig.ourMen || header.signature[1] != sig.ourKings
+        || header.signature[2] != sig.theirMen || header.signature[3] != sig.theirKings
+        || header.positions != sig.size() || header.blockSize != TB_BLOCK_SIZE)
+        return false;
+
+    std::vector<uint64_t> offsets(header.blockCount + 1);
+    if (!file.read(reinterpret_cast<char*>(offsets.data()), offsets.size() * sizeof(uint64_t)))
+        return false;
+
+    std::vector<uint8_t> data(offsets.back());
+    if (!file.read(reinterpret_cast<char*>(data.data()), data.size()))
+        return false;
+
+    values.assign(header.positions, TB_DRAW);
+    for (uint64_t b = 0; b < header.blockCount; ++b) {
+        uint64_t first = b * TB_BLOCK_SIZE;
+        uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(TB_BLOCK_SIZE, header.positions - first));
+        if (offsets[b] > offsets[b + 1] || offsets[b + 1] > data.size()
+            || !tbDecompressBlock(data.data() + offsets[b], offsets[b + 1] - offsets[b], values.data() + first, count))
+            return false;
+    }
+
+    dtw = header.dtw != 0;
+    return true;
+}
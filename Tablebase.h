@@ -0,0 +1,188 @@
+/**
+ * @file Tablebase.h
+ * @brief Implements the endgame tablebase layout shared by the generator and the search.
+ *
+ * Positions are always stored from the side to move's point of view: if Red is
+ * to move the board is rotated (square s becomes 31 - s) and the colours are
+ * swapped, so "us" is always Black moving towards row 0. A material signature
+ * (our men/kings, their men/kings) selects one table; inside it every position
+ * has a dense index built from combinatorial ranks of each piece group.
+ *
+ * Tables are written as one file per signature. Values are run-length encoded
+ * in fixed-size blocks behind an offset table, so a single position can be
+ * read by decompressing one small block.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "Position.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static const int TB_MAX_PIECES = 8;          ///< Largest piece count the index supports
+static const uint32_t TB_BLOCK_SIZE = 4096;  ///< Positions per compressed block
+
+/**
+ * @brief Value codes stored per position.
+ *
+ * In distance-to-win (DTW) tables a code c in [1, 254] means the game ends in
+ * c - 1 plies with best play: the side to move wins if that is odd and loses
+ * if it is even (0 plies = no legal move). WDL tables only use TB_DRAW,
+ * TB_LOSS (1) and TB_WIN (2).
+ */
+enum TBCode : uint8_t {
+    TB_DRAW = 0,       ///< Draw (or, while generating, not yet resolved)
+    TB_LOSS = 1,       ///< WDL loss / DTW "lost now"
+    TB_WIN = 2,        ///< WDL win / DTW "wins in one ply"
+    TB_MAX_DTW = 254,  ///< Largest DTW code
+    TB_INVALID = 255   ///< Index that does not decode to a legal placement
+};
+
+/// @brief Returns true if a DTW code means the side to move wins.
+constexpr bool dtwIsWin(uint8_t code) {
+    return code != TB_DRAW && code != TB_INVALID && (code % 2) == 0;
+}
+
+/// @brief Returns true if a DTW code means the side to move loses.
+constexpr bool dtwIsLoss(uint8_t code) {
+    return code != TB_INVALID && (code % 2) == 1;
+}
+
+/// @brief Converts a DTW code to its WDL code.
+constexpr uint8_t dtwToWdl(uint8_t code) {
+    return dtwIsWin(code) ? uint8_t(TB_WIN) : dtwIsLoss(code) ? uint8_t(TB_LOSS) : code;
+}
+
+/**
+ * @struct MaterialSignature
+ * @brief Piece counts of a table, seen from the side to move.
+ */
+struct MaterialSignature {
+    uint8_t ourMen = 0;      ///< Men of the side to move
+    uint8_t ourKings = 0;    ///< Kings of the side to move
+    uint8_t theirMen = 0;    ///< Men of the opponent
+    uint8_t theirKings = 0;  ///< Kings of the opponent
+
+    /// @brief Total number of pieces.
+    int pieces() const { return ourMen + ourKings + theirMen + theirKings; }
+
+    /// @brief Total number of men (promotions only ever lower it).
+    int men() const { return ourMen + theirMen; }
+
+    /// @brief The same material with the other side to move.
+    MaterialSignature mirrored() const { return { theirMen, theirKings, ourMen, ourKings }; }
+
+    /// @brief Number of indices in the table (including invalid ones).
+    uint64_t size() const;
+
+    /// @brief File name of the table, e.g. "tb_02_01.ctb" for two kings against one king.
+    std::string fileName() const;
+
+    bool operator==(const MaterialSignature& other) const {
+        return ourMen == other.ourMen && ourKings == other.ourKings
+            && theirMen == other.theirMen && theirKings == other.theirKings;
+    }
+    bool operator!=(const MaterialSignature& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Rotates and recolours a position so that Black is to move.
+ * @param pos Any position.
+ * @return The same position seen from the side to move.
+ */
+Position tbCanonical(const Position& pos);
+
+/**
+ * @brief Returns the signature of a position already in canonical form.
+ */
+MaterialSignature tbSignature(const Position& canonical);
+
+/**
+ * @brief Computes the index of a canonical position inside its table.
+ */
+uint64_t tbIndex(const Position& canonical, const MaterialSignature& sig);
+
+/**
+ * @brief Rebuilds the canonical position stored at an index.
+ * @param sig The table's signature.
+ * @param index Index inside the table.
+ * @param pos Receives the position (Black to move).
+ * @return false if the index is not a legal placement (two men on one square).
+ */
+bool tbPosition(const MaterialSignature& sig, uint64_t index, Position& pos);
+
+/**
+ * @brief Lists every signature with 2..maxPieces pieces and at least one piece a side.
+ *
+ * Ordered so that every table comes after all the tables its moves lead to:
+ * by piece count, then by number of men.
+ */
+std::vector<MaterialSignature> tbSignatures(int maxPieces);
+
+/**
+ * @struct TBFileHeader
+ * @brief Fixed header at the start of every table file.
+ *
+ * Followed by blockCount + 1 little-endian uint64 offsets (relative to the end
+ * of the offset table; the last one is the total compressed size) and then the
+ * compressed blocks.
+ */
+struct TBFileHeader {
+    char magic[4] = { 'C', 'K', 'T', 'B' };  ///< File identifier
+    uint16_t version = 1;                    ///< Format version
+    uint8_t dtw = 0;                         ///< 1 if values are DTW codes, 0 for WDL codes
+    uint8_t reserved = 0;                    ///< Padding
+    uint8_t signature[4] = {};               ///< ourMen, ourKings, theirMen, theirKings
+    uint32_t blockSize = TB_BLOCK_SIZE;      ///< Positions per block
+    uint64_t positions = 0;                  ///< Number of indices in the table
+    uint64_t blockCount = 0;                 ///< Number of compressed blocks
+};
+
+/**
+ * @brief Run-length encodes one block of values.
+ *
+ * Invalid entries are "don't care" and are merged into the surrounding runs.
+ *
+ * @param values The block's values.
+ * @param count Number of values.
+ * @param out Receives the encoded bytes (appended).
+ */
+void tbCompressBlock(const uint8_t* values, uint32_t count, std::vector<uint8_t>& out);
+
+/**
+ * @brief Decodes one block written by tbCompressBlock().
+ * @param data Encoded bytes.
+ * @param size Number of encoded bytes.
+ * @param values Receives the decoded values.
+ * @param count Number of values the block holds.
+ * @return false if the data is corrupt.
+ */
+bool tbDecompressBlock(const uint8_t* data, size_t size, uint8_t* values, uint32_t count);
+
+/**
+ * @brief Writes a whole table to disk (via a temporary file and rename, so it is all-or-nothing).
+ * @param path Destination file.
+ * @param sig The table's signature.
+ * @param values One DTW code per index.
+ * @param dtw Keep distances; otherwise store WDL codes only.
+ * @return true on success.
+ */
+bool tbWriteFile(const std::string& path, const MaterialSignature& sig,
+                 const std::vector<uint8_t>& values, bool dtw);
+
+/**
+ * @brief Reads and fully decompresses a table file.
+ * @param path Table file.
+ * @param sig Signature the file must have.
+ * @param values Receives one code per index.
+ * @param dtw Receives whether the codes are DTW codes.
+ * @return false if the file is missing, truncated or for another signature.
+ */
+bool tbReadFile(const std::string& path, const MaterialSignature& sig,
+                std::vector<uint8_t>& values, bool& dtw);
+
+#endif // TABLEBASE_H
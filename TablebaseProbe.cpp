@@ -0,0 +1,230 @@
+/**
+ * @file TablebaseProbe.cpp
+ * @brief Implements read-only access to the endgame tablebases for the search.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "TablebaseProbe.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+const int SIGNATURE_SLOTS = (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1);
+
+}
+
+/// @brief Snapshots the counters.
+TBProbeStats TBBlockCache::stats() const {
+    TBProbeStats result;
+    result.probes = probes.load(std::memory_order_relaxed);
+    result.hits = hits.load(std::memory_order_relaxed);
+    result.blockHits = blockHits.load(std::memory_order_relaxed);
+    result.blockMisses = blockMisses.load(std::memory_order_relaxed);
+    return result;
+}
+
+/// @brief Zeroes the counters.
+void TBBlockCache::resetStats() {
+    probes = 0;
+    hits = 0;
+    blockHits = 0;
+    blockMisses = 0;
+}
+
+/// @brief Drops every block.
+void TBBlockCache::clear() {
+    lru.clear();
+    index.clear();
+}
+
+/// @brief Starts with no tables.
+TablebaseProbe::TablebaseProbe() : tableForSignature(SIGNATURE_SLOTS, -1) {}
+
+/// @brief Unmaps whatever is still loaded.
+TablebaseProbe::~TablebaseProbe() {
+    unload();
+}
+
+/// @brief Maps every known signature's file and works out the complete piece count.
+int TablebaseProbe::load(const std::string& directory) {
+    unload();
+
+    for (const MaterialSignature& sig : tbSignatures(TB_MAX_PIECES)) {
+        Table table;
+        if (!mapTable(directory + "/" + sig.fileName(), sig, table))
+            continue;
+        tableForSignature[signatureSlot(sig)] = static_cast<int>(tables.size());
+        tables.push_back(std::move(table));
+    }
+
+    // Only probe piece counts whose tables are all there, so a probe never
+    // answers for one material and misses a position its captures lead to
+    std::vector<MaterialSignature> all = tbSignatures(TB_MAX_PIECES);
+    for (int pieces = 2; pieces <= TB_MAX_PIECES; ++pieces) {
+        bool complete = true;
+        for (const MaterialSignature& sig : all)
+            if (sig.pieces() == pieces && tableForSignature[signatureSlot(sig)] < 0)
+                complete = false;
+        if (!complete)
+            break;
+        maxPieceCount = pieces;
+    }
+
+    return static_cast<int>(tables.size());
+}
+
+/// @brief Unmaps every table and empties the cache.
+void TablebaseProbe::unload() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    sharedCache.clear();
+    generation++;  // Thread caches empty themselves on their next probe
+
+    tables.clear();  // Unmaps every file
+    std::fill(tableForSignature.begin(), tableForSignature.end(), -1);
+    maxPieceCount = 0;
+}
+
+/// @brief Probes through the shared cache under its lock.
+bool TablebaseProbe::probe(const Position& pos, WDL& result, int& plies) {
+    if (__builtin_popcount(pos.occupied()) > maxPieceCount)
+        return false;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return probe(pos, result, plies, sharedCache);
+}
+
+/// @brief Finds the position's table and reads its code.
+bool TablebaseProbe::probe(const Position& pos, WDL& result, int& plies, TBBlockCache& cache) {
+    if (__builtin_popcount(pos.occupied()) > maxPieceCount)
+        return false;
+    TBBlockCache::count(cache.probes);
+
+    Position canonical = tbCanonical(pos);
+    MaterialSignature sig = tbSignature(canonical);
+    int tableNumber = tableForSignature[signatureSlot(sig)];
+    if (tableNumber < 0)
+        return false;
+
+    uint8_t code;
+    if (!readValue(cache, tableNumber, tbIndex(canonical, sig), code) || code == TB_INVALID)
+        return false;
+
+    result = dtwIsWin(code) ? WDL::Win : dtwIsLoss(code) ? WDL::Loss : WDL::Draw;
+    plies = (tables[tableNumber].dtw && code != TB_DRAW) ? code - 1 : -1;
+    TBBlockCache::count(cache.hits);
+    return true;
+}
+
+/// @brief Changes the cache capacity.
+void TablebaseProbe::setCacheSize(size_t blocks) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    sharedCache.clear();
+    generation++;
+    cacheCapacity = blocks ? blocks : 1;
+}
+
+/// @brief Snapshots the shared cache's counters.
+TBProbeStats TablebaseProbe::stats() const {
+    return sharedCache.stats();
+}
+
+/// @brief Zeroes the shared cache's counters.
+void TablebaseProbe::resetStats() {
+    sharedCache.resetStats();
+}
+
+/// @brief Looks the block up in the cache's LRU list, decompressing it on a miss.
+bool TablebaseProbe::readValue(TBBlockCache& cache, int tableNumber, uint64_t index, uint8_t& value) {
+    const Table& table = tables[tableNumber];
+    if (index >= table.positions)
+        return false;
+
+    uint64_t block = index / TB_BLOCK_SIZE;
+    uint32_t offset = static_cast<uint32_t>(index % TB_BLOCK_SIZE);
+    uint64_t key = (static_cast<uint64_t>(tableNumber) << 32) | block;
+
+    // Blocks decompressed from an earlier load of the tables are stale
+    if (cache.generation != generation) {
+        cache.clear();
+        cache.generation = generation;
+    }
+
+    std::list<TBBlockCache::CachedBlock>& lru = cache.lru;
+    auto it = cache.index.find(key);
+    if (it != cache.index.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+        value = it->second->values[offset];
+        TBBlockCache::count(cache.blockHits);
+        return true;
+    }
+    TBBlockCache::count(cache.blockMisses);
+
+    // Reuse the least recently used block once the cache is full
+    if (lru.size() >= cacheCapacity) {
+        cache.index.erase(lru.back().key);
+        lru.splice(lru.begin(), lru, std::prev(lru.end()));
+    } else {
+        lru.emplace_front();
+    }
+
+    TBBlockCache::CachedBlock& cached = lru.front();
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(TB_BLOCK_SIZE, table.positions - block * TB_BLOCK_SIZE));
+    uint64_t begin = table.offsets[block];
+    uint64_t end = table.offsets[block + 1];
+    if (begin > end || end > table.dataSize
+        || !tbDecompressBlock(table.data + begin, end - begin, cached.values, count)) {
+        lru.pop_front();
+        return false;
+    }
+
+    cached.key = key;
+    cache.index[key] = lru.begin();
+    value = cached.values[offset];
+    return true;
+}
+
+/// @brief Maps a file and checks the header and offset table against the mapping.
+bool TablebaseProbe::mapTable(const std::string& path, const MaterialSignature& sig, Table& table) {
+    if (!table.file.map(path))
+        return false;
+    const uint8_t* base = table.file.data();
+    size_t size = table.file.size();
+
+    TBFileHeader header;
+    bool valid = size >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, base, sizeof(header));
+        valid = std::memcmp(header.magic, "CKTB", 4) == 0 && header.version == 1
+             && header.signature[0] == sig.ourMen && header.signature[1] == sig.ourKings
+             && header.signature[2] == sig.theirMen && header.signature[3] == sig.theirKings
+             && header.blockSize == TB_BLOCK_SIZE && header.positions == sig.size()
+             && header.blockCount == (header.positions + TB_BLOCK_SIZE - 1) / TB_BLOCK_SIZE;
+    }
+
+    // The offsets must fit in the file, and so must the data they point to
+    size_t dataStart = sizeof(header) + (header.blockCount + 1) * sizeof(uint64_t);
+    valid = valid && dataStart <= size;
+    if (valid) {
+        table.offsets = reinterpret_cast<const uint64_t*>(base + sizeof(header));
+        table.data = base + dataStart;
+        table.dataSize = table.offsets[header.blockCount];
+        valid = table.dataSize <= size - dataStart;
+    }
+
+    if (!valid) {
+        table.file.unmap();
+        return false;
+    }
+    table.positions = header.positions;
+    table.dtw = header.dtw != 0;
+    return true;
+}
+
+/// @brief Packs the four counts into one base-(TB_MAX_PIECES + 1) number.
+int TablebaseProbe::signatureSlot(const MaterialSignature& sig) {
+    const int radix = TB_MAX_PIECES + 1;
+    return ((sig.ourMen * radix + sig.ourKings) * radix + sig.theirMen) * radix + sig.theirKings;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file TablebaseProbe.h
+ * @brief Implements read-only access to the endgame tablebases for the search.
+ *
+ * Table files written by the tbgen tool are memory-mapped, so opening them
+ * costs nothing until a position is probed. A probe decompresses only the
+ * block holding that position and keeps recently used blocks in an LRU cache;
+ * a probe that hits the cache is a hash lookup and an array read. Each search
+ * thread passes its own TBBlockCache so its probes never take a lock; probes
+ * without one share a cache behind a mutex.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef TABLEBASEPROBE_H
+#define TABLEBASEPROBE_H
+
+#include "MappedFile.h"
+#include "Position.h"
+#include "Tablebase.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Result of a position with best play, for the side to move.
+enum class WDL : int8_t {
+    Loss = -1,
+    Draw = 0,
+    Win = 1
+};
+
+/**
+ * @struct TBProbeStats
+ * @brief Counters of the probes since the tables were loaded.
+ */
+struct TBProbeStats {
+    uint64_t probes = 0;       ///< Calls to probe() with few enough pieces
+    uint64_t hits = 0;         ///< Probes answered from a table
+    uint64_t blockHits = 0;    ///< Answers found in an already decompressed block
+    uint64_t blockMisses = 0;  ///< Answers that needed a block decompressed
+
+    /// @brief Fraction of answers that had to decompress a block.
+    double missRate() const {
+        uint64_t lookups = blockHits + blockMisses;
+        return lookups ? static_cast<double>(blockMisses) / lookups : 0.0;
+    }
+};
+
+class TablebaseProbe;
+
+/**
+ * @class TBBlockCache
+ * @brief Decompressed blocks kept for one thread, so its probes never lock.
+ *
+ * Only the owning thread may probe through it. It empties itself when the
+ * tables are reloaded, and holds at most TablebaseProbe's cache size.
+ */
+class TBBlockCache {
+public:
+    TBBlockCache() = default;
+    TBBlockCache(const TBBlockCache&) = delete;
+    TBBlockCache& operator=(const TBBlockCache&) = delete;
+
+    /// @brief Returns the counters of the probes made through this cache.
+    TBProbeStats stats() const;
+
+    /// @brief Zeroes the counters.
+    void resetStats();
+
+private:
+    friend class TablebaseProbe;
+
+    /// @brief One decompressed block.
+    struct CachedBlock {
+        uint64_t key = 0;                  ///< Table number << 32 | block number
+        uint8_t values[TB_BLOCK_SIZE];     ///< Decompressed codes
+    };
+
+    std::list<CachedBlock> lru;            ///< Most recently used block first
+    std::unordered_map<uint64_t, std::list<CachedBlock>::iterator> index;  ///< key -> block
+    uint64_t generation = 0;               ///< Load of the tables the blocks came from
+
+    // Written only by the owning thread (or under the shared cache's mutex), read by anyone
+    std::atomic<uint64_t> probes{0};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> blockHits{0};
+    std::atomic<uint64_t> blockMisses{0};
+
+    /// @brief Adds one without a locked read-modify-write.
+    static void count(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void clear();
+};
+
+/**
+ * @class TablebaseProbe
+ * @brief Maps the table files and answers win/loss/draw queries from several threads.
+ */
+class TablebaseProbe {
+public:
+    static const size_t DEFAULT_CACHE_BLOCKS = 1024;  ///< Cached blocks (4 KiB each)
+
+    TablebaseProbe();
+    ~TablebaseProbe();
+
+    TablebaseProbe(const TablebaseProbe&) = delete;
+    TablebaseProbe& operator=(const TablebaseProbe&) = delete;
+
+    /**
+     * @brief Maps every table file found in a directory, replacing any loaded before.
+     * @param directory Directory the tbgen tool wrote to.
+     * @return Number of tables mapped.
+     */
+    int load(const std::string& directory);
+
+    /// @brief Unmaps every table and empties the cache.
+    void unload();
+
+    /**
+     * @brief Largest piece count for which every table is loaded (0 if none).
+     *
+     * Positions with more pieces are never probed.
+     */
+    int maxPieces() const { return maxPieceCount; }
+
+    /**
+     * @brief Looks a position up through the shared cache. Safe to call from several threads at once.
+     * @param pos The position (either side to move).
+     * @param result Receives the result for the side to move.
+     * @param plies Receives the number of plies to the end of the game if the
+     *        table keeps distances and the position is decided, otherwise -1.
+     * @return false if the position is not covered by the loaded tables.
+     */
+    bool probe(const Position& pos, WDL& result, int& plies);
+
+    /**
+     * @brief Looks a position up through the calling thread's own cache, without locking.
+     *
+     * Several threads may probe at once as long as each uses its own cache;
+     * the tables must not be loaded or unloaded meanwhile.
+     */
+    bool probe(const Position& pos, WDL& result, int& plies, TBBlockCache& cache);
+
+    /**
+     * @brief Sets how many decompressed blocks each cache keeps (and empties them).
+     * @param blocks Number of 4 KiB blocks, at least 1.
+     */
+    void setCacheSize(size_t blocks);
+
+    /// @brief Returns the counters of the probes made through the shared cache.
+    TBProbeStats stats() const;
+
+    /// @brief Zeroes the shared cache's counters.
+    void resetStats();
+
+private:
+    /// @brief One memory-mapped table file.
+    struct Table {
+        MappedFile file;                   ///< The mapped file
+        const uint64_t* offsets = nullptr; ///< Block offsets (blockCount + 1)
+        const uint8_t* data = nullptr;     ///< Compressed blocks
+        uint64_t dataSize = 0;             ///< Bytes of compressed blocks
+        uint64_t positions = 0;            ///< Indices in the table
+        bool dtw = false;                  ///< Values are distance codes
+    };
+
+    std::vector<Table> tables;             ///< Mapped tables
+    std::vector<int> tableForSignature;    ///< Signature slot -> index into tables, or -1
+    int maxPieceCount = 0;                 ///< See maxPieces()
+
+    std::mutex cacheMutex;                 ///< Guards the shared cache
+    TBBlockCache sharedCache;              ///< Cache of probes made without one of their own
+    size_t cacheCapacity = DEFAULT_CACHE_BLOCKS;  ///< Blocks kept at most, per cache
+    uint64_t generation = 1;               ///< Bumped whenever the tables or the cache size change
+
+    /// @brief Maps one file and checks its header; returns false if it is unusable.
+    static bool mapTable(const std::string& path, const MaterialSignature& sig, Table& table);
+
+    /// @brief Dense slot of a signature in tableForSignature.
+    static int signatureSlot(const MaterialSignature& sig);
+
+    /**
+     * @brief Reads one value, decompressing its block if the cache lacks it.
+     * @return false if the block is corrupt.
+     */
+    bool readValue(TBBlockCache& cache, int tableNumber, uint64_t index, uint8_t& value);
+};
+
+#endif // TABLEBASEPROBE_H
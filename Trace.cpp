@@ -0,0 +1,173 @@
+/**
+ * @file Trace.cpp
+ * @brief Implements timed trace events written as a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+/// @brief One completed event.
+struct TraceEvent {
+    const char* name;
+    const char* argName;
+    int64_t arg;
+    int64_t start;     ///< Nanoseconds since the trace started
+    int64_t duration;  ///< Nanoseconds
+};
+
+/**
+ * @struct TraceBuffer
+ * @brief Ring of one thread's newest events; only that thread writes to it.
+ */
+struct TraceBuffer {
+    int thread = 0;                    ///< Thread number in the trace
+    std::atomic<uint64_t> written{0};  ///< Events ever recorded; the newest is at (written - 1) % size
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+};
+
+/// @brief Everything shared between threads; only touched when a thread first traces and when writing.
+struct TraceState {
+    std::mutex mutex;
+    std::vector<TraceBuffer*> buffers;  ///< Kept after their thread exits, until written
+    std::vector<TraceBuffer*> idle;     ///< Buffers of exited threads, handed to the next new thread
+    std::string path;
+    bool started = false;
+    bool exitHandlerSet = false;
+};
+
+// Never destroyed, so the exit handler can still use it
+TraceState& state() {
+    static TraceState* shared = new TraceState();
+    return *shared;
+}
+
+std::atomic<int64_t> origin{0};  ///< steady_clock time of the start, in nanoseconds
+
+/**
+ * @struct BufferLease
+ * @brief A thread's hold on its buffer, given back when the thread exits.
+ *
+ * The search starts new helper threads for every move, so buffers are reused
+ * rather than one being added per thread ever started.
+ */
+struct BufferLease {
+    TraceBuffer* buffer = nullptr;
+
+    ~BufferLease() {
+        if (buffer) {
+            TraceState& shared = state();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.idle.push_back(buffer);
+        }
+    }
+};
+
+thread_local BufferLease lease;
+
+int64_t clockNanos() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/// @brief The calling thread's buffer, created on its first event.
+TraceBuffer* threadBuffer() {
+    if (!lease.buffer) {
+        TraceState& shared = state();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (!shared.idle.empty()) {
+            lease.buffer = shared.idle.back();
+            shared.idle.pop_back();
+        } else {
+            lease.buffer = new TraceBuffer();
+            lease.buffer->thread = static_cast<int>(shared.buffers.size());
+            shared.buffers.push_back(lease.buffer);
+        }
+    }
+    return lease.buffer;
+}
+
+void writeAtExit() {
+    Trace::stop();
+}
+
+}
+
+std::atomic<bool> Trace::active{false};
+
+/// @brief Reads CHECKERS_TRACE and starts recording into that file.
+bool Trace::startFromEnvironment() {
+    const char* path = std::getenv("CHECKERS_TRACE");
+    return path && *path && start(path);
+}
+
+/// @brief Sets the output file and the time origin, then turns recording on.
+bool Trace::start(const std::string& path) {
+    TraceState& shared = state();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (shared.started)
+        return false;
+
+    shared.path = path;
+    shared.started = true;
+    if (!shared.exitHandlerSet) {
+        std::atexit(writeAtExit);
+        shared.exitHandlerSet = true;
+    }
+    origin.store(clockNanos(), std::memory_order_relaxed);
+    active.store(true, std::memory_order_release);
+    return true;
+}
+
+/// @brief Turns recording off and writes every thread's buffer as complete ("X") events.
+bool Trace::stop() {
+    TraceState& shared = state();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (!shared.started)
+        return true;
+    shared.started = false;
+    active.store(false, std::memory_order_relaxed);
+
+    FILE* out = std::fopen(shared.path.c_str(), "w");
+    if (!out)
+        return false;
+
+    std::fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+    bool first = true;
+    for (TraceBuffer* buffer : shared.buffers) {
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t begin = (written > TRACE_BUFFER_EVENTS) ? written - TRACE_BUFFER_EVENTS : 0;
+        for (uint64_t i = begin; i < written; ++i) {
+            const TraceEvent& event = buffer->events[i & (TRACE_BUFFER_EVENTS - 1)];
+            std::fprintf(out, "%s\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+                         first ? "" : ",", event.name, buffer->thread, event.start / 1000.0, event.duration / 1000.0);
+            if (event.argName)
+                std::fprintf(out, ", \"args\": {\"%s\": %lld}", event.argName, static_cast<long long>(event.arg));
+            std::fprintf(out, "}");
+            first = false;
+        }
+        buffer->written.store(0, std::memory_order_relaxed);
+    }
+    std::fprintf(out, "\n]}\n");
+    return std::fclose(out) == 0;
+}
+
+/// @brief Nanoseconds since start().
+int64_t Trace::now() {
+    return clockNanos() - origin.load(std::memory_order_relaxed);
+}
+
+/// @brief Overwrites the oldest slot of the thread's ring once it is full.
+void Trace::record(const char* name, int64_t startNanos, int64_t endNanos, const char* argName, int64_t arg) {
+    TraceBuffer* buffer = threadBuffer();
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    buffer->events[index & (TRACE_BUFFER_EVENTS - 1)] = { name, argName, arg, startNanos, endNanos - startNanos };
+    buffer->written.store(index + 1, std::memory_order_release);
+}
@@ -0,0 +1,123 @@
+/**
+ * @file Trace.h
+ * @brief Implements timed trace events written as a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * A TRACE_SCOPE("name") records how long the rest of its block takes. Each
+ * thread writes its events into its own ring buffer with no locks, keeping
+ * the newest TRACE_BUFFER_EVENTS; the buffers are only read when the trace is
+ * written, once every thread that traced has finished. A thread that exits
+ * leaves its buffer to the next new one, so a trace "thread" may stand for
+ * several short-lived threads that never ran at the same time.
+ *
+ * Recording is off unless the environment variable CHECKERS_TRACE names the
+ * output file when Trace::startFromEnvironment() runs; the file is written
+ * when the program exits. Disabled, a scope costs one relaxed atomic load;
+ * building with DEFINES+=NO_TRACE removes the scopes altogether.
+ *
+ * Only coarse events belong here (a move, a search iteration, a sound):
+ * tracing every node of the search would fill the buffers in milliseconds,
+ * so hot calls are sampled with TRACE_SCOPE_IF.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+static const int TRACE_BUFFER_EVENTS = 1 << 15;  ///< Events kept per thread (power of two)
+
+/**
+ * @class Trace
+ * @brief Process-wide switch and writer of the trace.
+ */
+class Trace {
+public:
+    /**
+     * @brief Starts recording if CHECKERS_TRACE is set, and writes the file at exit.
+     * @return true if tracing is on.
+     */
+    static bool startFromEnvironment();
+
+    /**
+     * @brief Starts recording into a file written by stop() (or at exit).
+     * @return false if tracing was already started.
+     */
+    static bool start(const std::string& path);
+
+    /**
+     * @brief Stops recording and writes every buffered event.
+     *
+     * No traced thread may still be running.
+     *
+     * @return false if the file cannot be written.
+     */
+    static bool stop();
+
+    /// @brief Returns true while events are recorded.
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    /// @brief Nanoseconds since the trace started.
+    static int64_t now();
+
+    /**
+     * @brief Adds a completed event to the calling thread's buffer.
+     * @param name Static string naming the event.
+     * @param argName Static string naming the argument, or null for none.
+     */
+    static void record(const char* name, int64_t startNanos, int64_t endNanos, const char* argName, int64_t arg);
+
+private:
+    static std::atomic<bool> active;
+};
+
+/**
+ * @class TraceScope
+ * @brief Records one event lasting from its construction to the end of its scope.
+ */
+class TraceScope {
+public:
+    /**
+     * @param name Static string naming the event.
+     * @param argName Static string naming an integer shown with the event, or null.
+     * @param arg The integer.
+     */
+    explicit TraceScope(const char* name, const char* argName = nullptr, int64_t arg = 0)
+        : name(Trace::enabled() ? name : nullptr), argName(argName), arg(arg),
+          start(this->name ? Trace::now() : 0) {}
+
+    ~TraceScope() {
+        if (name)
+            Trace::record(name, start, Trace::now(), argName, arg);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;     ///< Null when tracing was off at construction
+    const char* argName;
+    int64_t arg;
+    int64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef NO_TRACE
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_ARG(name, argName, arg) ((void)0)
+#define TRACE_SCOPE_IF(condition, name) ((void)0)
+#else
+/// @brief Traces the rest of the enclosing block.
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+/// @brief Traces the rest of the enclosing block, showing an integer with the event.
+#define TRACE_SCOPE_ARG(name, argName, arg) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, argName, arg)
+/// @brief Traces the rest of the enclosing block only when the condition holds, e.g. to sample a hot call.
+#define TRACE_SCOPE_IF(condition, name) TraceScope TRACE_CONCAT(traceScope, __LINE__)((condition) ? (name) : nullptr)
+#endif
+
+#endif // TRACE_H
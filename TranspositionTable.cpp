@@ -0,0 +1,117 @@
+/**
+ * @file TranspositionTable.cpp
+ * @brief Implements the fixed-size transposition table shared by iterations and moves.
+ *
+ * Entries are grouped four to a 64-byte bucket so a probe touches a single
+ * cache line. Each entry keeps the search depth, bound type, score and best
+ * move of a position, keyed by its Zobrist hash. Slots are read and written
+ * without locks and verified with an XOR of key and data.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "TranspositionTable.h"
+#include <algorithm>
+
+static_assert(sizeof(std::atomic<uint64_t>) == 8, "TT entries must stay 16 bytes");
+
+/// @brief Allocates the table.
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+/// @brief Rounds the size down to a power of two of buckets and clears it.
+void TranspositionTable::resize(size_t megabytes) {
+    size_t count = std::max<size_t>(1, megabytes) * 1024 * 1024 / sizeof(Bucket);
+    size_t powerOfTwo = 1;
+    while (powerOfTwo * 2 <= count)
+        powerOfTwo *= 2;
+
+    buckets.reset(new Bucket[powerOfTwo]);
+    bucketCount = powerOfTwo;
+    mask = powerOfTwo - 1;
+    generation = 0;
+}
+
+/// @brief Empties every slot.
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; ++i) {
+        for (Slot& slot : buckets[i].entries) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+/// @brief Advances the 6-bit generation counter.
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & 0x3F;
+}
+
+/// @brief Scans the bucket for a slot whose verified key matches.
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = bucketFor(key);
+    for (const Slot& slot : bucket.entries) {
+        TTEntry stored = slot.load();
+        if (stored.key == key && stored.bound() != Bound::None) {
+            entry = stored;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Overwrites the same position, or else the shallowest / oldest slot.
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound, const Move& move) {
+    Bucket& bucket = bucketFor(key);
+
+    Slot* target = &bucket.entries[0];
+    TTEntry old = target->load();
+    int worstValue = 1 << 30;
+    for (Slot& slot : bucket.entries) {
+        TTEntry stored = slot.load();
+        if (stored.key == key || stored.bound() == Bound::None) {
+            target = &slot;
+            old = stored;
+            break;
+        }
+
+        // Prefer to evict entries from older searches, then shallower ones
+        int age = (generation - stored.generation()) & 0x3F;
+        int value = stored.depth() - 8 * age;
+        if (value < worstValue) {
+            worstValue = value;
+            target = &slot;
+            old = stored;
+        }
+    }
+
+    // Keep the old best move if this result has none
+    uint8_t from = move.from, to = move.to, first = move.firstLanding();
+    if (move.isNull() && old.key == key) {
+        from = old.moveFrom();
+        to = old.moveTo();
+        first = old.moveFirstLanding();
+    }
+
+    // Don't let a shallow bound overwrite a deeper result for the same position
+    if (old.key == key && bound != Bound::Exact && depth < old.depth() - 2
+        && old.generation() == generation)
+        return;
+
+    uint64_t data = static_cast<uint64_t>(static_cast<uint16_t>(static_cast<int16_t>(score)))
+                  | (static_cast<uint64_t>(std::min(depth, 255)) << 16)
+                  | (static_cast<uint64_t>(bound) << 24)
+                  | (static_cast<uint64_t>(generation) << 26)
+                  | (static_cast<uint64_t>(from) << 32)
+                  | (static_cast<uint64_t>(to) << 40)
+                  | (static_cast<uint64_t>(first) << 48);
+    target->data.store(data, std::memory_order_relaxed);
+    target->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+/// @brief Returns the allocated size in MiB.
+size_t TranspositionTable::sizeMB() const {
+    return bucketCount * sizeof(Bucket) / (1024 * 1024);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file TranspositionTable.h
+ * @brief Implements the fixed-size transposition table shared by iterations and moves.
+ *
+ * Entries are grouped four to a 64-byte bucket so a probe touches a single
+ * cache line. Each entry keeps the search depth, bound type, score and best
+ * move of a position, keyed by its Zobrist hash.
+ *
+ * The table is shared by every search thread without locks: each slot stores
+ * (key ^ data) next to data, so a slot torn by two threads writing at once
+ * fails the key check on probe and is simply treated as a miss.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include "Position.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @enum Bound
+ * @brief What a stored score means relative to the true value.
+ */
+enum class Bound : uint8_t {
+    None = 0,   ///< Empty slot
+    Upper = 1,  ///< Fail-low: true score <= stored score
+    Lower = 2,  ///< Fail-high: true score >= stored score
+    Exact = 3   ///< Score is exact
+};
+
+/**
+ * @struct TTEntry
+ * @brief A probed entry: the full key plus a packed data word.
+ *
+ * Data layout (low to high): score (16), depth (8), bound (2), generation (6),
+ * move from (8), move to (8), move first landing (8).
+ */
+struct TTEntry {
+    uint64_t key = 0;   ///< Zobrist hash of the position
+    uint64_t data = 0;  ///< Packed score/depth/bound/generation/move
+
+    int score() const { return static_cast<int16_t>(data & 0xFFFF); }
+    int depth() const { return static_cast<int>((data >> 16) & 0xFF); }
+    Bound bound() const { return static_cast<Bound>((data >> 24) & 0x3); }
+    int generation() const { return static_cast<int>((data >> 26) & 0x3F); }
+    uint8_t moveFrom() const { return static_cast<uint8_t>(data >> 32); }
+    uint8_t moveTo() const { return static_cast<uint8_t>(data >> 40); }
+    uint8_t moveFirstLanding() const { return static_cast<uint8_t>(data >> 48); }
+
+    /// @brief Returns true if the stored best move is the given move.
+    bool matches(const Move& move) const {
+        return moveFrom() == move.from && moveTo() == move.to && moveFirstLanding() == move.firstLanding();
+    }
+};
+
+/**
+ * @class TranspositionTable
+ * @brief Hash table of previously searched positions.
+ */
+class TranspositionTable {
+public:
+    static const int BUCKET_SIZE = 4;  ///< Entries per 64-byte bucket
+
+    /**
+     * @brief Creates a table of roughly the given size.
+     * @param megabytes Table size in MiB (rounded down to a power of two of buckets).
+     */
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    /// @brief Reallocates the table and clears it (no search may be running).
+    void resize(size_t megabytes);
+
+    /// @brief Empties every slot (no search may be running).
+    void clear();
+
+    /// @brief Marks the start of a new search so older entries age out first.
+    void newSearch();
+
+    /**
+     * @brief Looks up a position.
+     * @param key Zobrist hash of the position.
+     * @param entry Receives the stored entry on a hit.
+     * @return true if the position was found.
+     */
+    bool probe(uint64_t key, TTEntry& entry) const;
+
+    /**
+     * @brief Stores a search result, replacing the least useful slot of the bucket.
+     * @param key Zobrist hash of the position.
+     * @param depth Remaining depth the score was searched to.
+     * @param score Score, with win/loss scores made relative to this position.
+     * @param bound Bound type of the score.
+     * @param move Best move found (may be null).
+     */
+    void store(uint64_t key, int depth, int score, Bound bound, const Move& move);
+
+    /// @brief Returns the table size in MiB.
+    size_t sizeMB() const;
+
+private:
+    /// One 16-byte slot; check holds key ^ data so torn writes are detected
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+
+        /// @brief Reads the slot; the key is 0 if the slot is empty.
+        TTEntry load() const {
+            TTEntry entry;
+            entry.data = data.load(std::memory_order_relaxed);
+            entry.key = check.load(std::memory_order_relaxed) ^ entry.data;
+            return entry;
+        }
+    };
+
+    struct alignas(64) Bucket {
+        Slot entries[BUCKET_SIZE];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;  ///< Power-of-two number of buckets
+    size_t bucketCount = 0;             ///< Number of buckets
+    uint64_t mask = 0;                  ///< bucketCount - 1
+    uint8_t generation = 0;             ///< Current search generation (6 bits)
+
+    Bucket& bucketFor(uint64_t key) { return buckets[key & mask]; }
+    const Bucket& bucketFor(uint64_t key) const { return buckets[key & mask]; }
+};
+
+#endif // TRANSPOSITIONTABLE_H
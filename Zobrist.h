@@ -0,0 +1,55 @@
+/**
+ * @file Zobrist.h
+ * @brief Compile-time Zobrist keys used to hash Positions for the transposition table.
+ *
+ * One 64-bit key per (side, man/king, square), plus one for Black to move.
+ * The keys come from a constexpr SplitMix64 sequence, so they are identical
+ * on every build and every run, which keeps hashes stable across games.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Position.h"
+#include <cstdint>
+
+/**
+ * @struct ZobristKeys
+ * @brief Random keys for every piece placement and for the side to move.
+ */
+struct ZobristKeys {
+    uint64_t piece[2][2][NUM_SQUARES] = {};  ///< [side][0 = man, 1 = king][square]
+    uint64_t blackToMove = 0;                ///< XORed in when Black is to move
+};
+
+/// @brief One step of the SplitMix64 generator.
+constexpr uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/// @brief Builds the Zobrist keys at compile time.
+constexpr ZobristKeys buildZobristKeys() {
+    ZobristKeys keys;
+    uint64_t state = 0x436865636B657273ull;  // "Checkers"
+    for (int side = 0; side < 2; ++side)
+        for (int kind = 0; kind < 2; ++kind)
+            for (int sq = 0; sq < NUM_SQUARES; ++sq)
+                keys.piece[side][kind][sq] = splitMix64(state);
+    keys.blackToMove = splitMix64(state);
+    return keys;
+}
+
+/// The Zobrist keys, generated at compile time.
+inline constexpr ZobristKeys ZOBRIST = buildZobristKeys();
+
+/// @brief Key of one piece on one square.
+constexpr uint64_t pieceKey(Side side, bool king, int square) {
+    return ZOBRIST.piece[static_cast<int>(side)][king ? 1 : 0][square];
+}
+
+#endif // ZOBRIST_H
@@ -9,6 +9,8 @@ TARGET = Checkers
 
 RESOURCES += resources.qrc
 
+include(engine.pri)
+
 SOURCES += \
     main.cpp \
     checkersmenu.cpp\
@@ -18,7 +20,7 @@ SOURCES += \
     piece.cpp\
     checkersmanager.cpp\
     AI.cpp\
-    MiniMaxAlgo.cpp\
+    AIWorker.cpp\
     Player.cpp\
     mainwindow.cpp\
     gamepage.cpp\
@@ -37,7 +39,7 @@ HEADERS += \
     piece.h\
     checkersmanager.h\
     AI.h\
-    MiniMaxAlgo.h\
+    AIWorker.h\
     Player.h\
     mainwindow.h\
     gamepage.h\
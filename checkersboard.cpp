@@ -12,13 +12,23 @@
 
 #include "checkersboard.h"
 #include "piece.h"
+#include "MoveTables.h"
+#include "Trace.h"
 #include <QGraphicsPixmapItem>
 #include <QGraphicsScene>
 #include <QPainter>
+#include <algorithm>
+#include <iterator>
 
 // Cell size for board layout
 static const int CELL_SIZE = 58;
 
+// Maps a piece color onto the side used by the move tables
+static Side toSide(PieceColor color)
+{
+    return (color == PieceColor::Red) ? Side::Red : Side::Black;
+}
+
 /**
  * @class BoardSquare
  * @brief Represents an individual square on the checkers board.
@@ -119,6 +129,7 @@ CheckersBoard::CheckersBoard(QWidget *parent)
  */
 void CheckersBoard::handleMove(Piece *piece, int newRow, int newCol)
 {
+    TRACE_SCOPE("CheckersBoard::handleMove");
 
     // Abort if no piece is passed
     if (!piece) {
@@ -149,32 +160,25 @@ void CheckersBoard::handleMove(Piece *piece, int newRow, int newCol)
             int midCol = (oldCol + newCol) / 2;
 
             // Looks for a capturable opponent piece at the midpoint
-            for (QGraphicsItem *item : m_scene->items()) {
-                Piece *midPiece = dynamic_cast<Piece *>(item);
-                if (midPiece && midPiece->getRow() == midRow && midPiece->getCol() == midCol) {
-                    if (midPiece->getColor() != piece->getColor()) {
-                        m_captureMade = true;
-                        capturedPieceId = midPiece->getId();
-                        capturedRow = midRow;
-                        capturedCol = midCol;
-                        capturedWasKing = midPiece->isKing();
-                        capturedColor = midPiece->getColor();
-
-                        // Remove from scene
-                        m_scene->removeItem(midPiece);
-                        delete midPiece;
-
-                        // Trigger capture event
-                        emit pieceCaptured();
-                        break;
-                    }
-                }
+            Piece *midPiece = getPieceAt(midRow, midCol);
+            if (midPiece && midPiece->getColor() != piece->getColor()) {
+                m_captureMade = true;
+                capturedPieceId = midPiece->getId();
+                capturedRow = midRow;
+                capturedCol = midCol;
+                capturedWasKing = midPiece->isKing();
+                capturedColor = midPiece->getColor();
+
+                // Remove from the board and the scene
+                m_pieces[squareOf(midRow, midCol)] = nullptr;
+                m_scene->removeItem(midPiece);
+                delete midPiece;
+
+                // Trigger capture event
+                emit pieceCaptured();
             }
         }
 
-        // Moves piece to new position
-        piece->setBoardPosition(newRow, newCol);
-
         // Checks for promotion to king
         bool wasPromoted = false;
         if (!piece->isKing()) {
@@ -186,6 +190,7 @@ void CheckersBoard::handleMove(Piece *piece, int newRow, int newCol)
 
         // Saves move for undo
         MoveRecord record;
+        record.mover = piece->getColor();
         record.pieceId = piece->getId();
         record.oldRow = oldRow;
         record.oldCol = oldCol;
@@ -199,12 +204,10 @@ void CheckersBoard::handleMove(Piece *piece, int newRow, int newCol)
         record.capturedWasKing = capturedWasKing;
         if (m_captureMade)
             record.capturedColor = capturedColor;
-        moveHistory.push(record);
+        moveHistory.push_back(record);
 
-        // Sets new visual position
-        qreal x = newCol * CELL_SIZE + (CELL_SIZE - piece->pixmap().width()) / 2.0;
-        qreal y = newRow * CELL_SIZE + (CELL_SIZE - piece->pixmap().height()) / 2.0;
-        piece->setPos(x, y);
+        // Moves piece to new position
+        placePiece(piece, newRow, newCol);
 
         // Removes old highlights
         clearHighlightedSquares();
@@ -224,6 +227,7 @@ void CheckersBoard::handleMove(Piece *piece, int newRow, int newCol)
         // Checks if another capture is available with the same piece
         if (m_captureMade && isCaptureAvailable(piece)) {
             selectedPiece = piece;
+            m_chainSquare = squareOf(newRow, newCol);  // Only this piece may continue
             highlightValidMoves(piece);
             if (piece->getColor() == PieceColor::Red) {
                 // Red triggers move complete after multi-capture
@@ -240,6 +244,7 @@ void CheckersBoard::handleMove(Piece *piece, int newRow, int newCol)
 
     // Clears selected piece and switch turn
     selectedPiece = nullptr;
+    m_chainSquare = -1;
     switchTurn();
 
     // Notifies rest of system about turn completion
@@ -253,57 +258,43 @@ void CheckersBoard::handleMove(Piece *piece, int newRow, int newCol)
 /**
  * @brief Checks if the given color has any valid move available.
  * 
- * Looks for either capture moves or normal moves for all pieces of the given color.
+ * Asks the shared move generator for the color's legal moves.
  * 
  * @param color The color to check moves for (Red or Black).
  * @return true if at least one valid move is available, false otherwise.
  */
 bool CheckersBoard::hasValidMoves(PieceColor color)
 {
-    // Loops through all items in the scene
-    for (QGraphicsItem *item : m_scene->items()) {
-        Piece *piece = dynamic_cast<Piece *>(item);
-
-        // Skips if not a piece or not the right color
-        if (!piece || piece->getColor() != color)
-            continue;
-        
-        int row = piece->getRow();
-        int col = piece->getCol();
-
-        // If any capture is possible, returns true
-        if (isCaptureAvailable(piece))
-            return true;
+    MoveList moves;
+    getLegalMoves(color, moves);
+    return !moves.empty();
+}
 
-        if (piece->isKing()) {
-            // Kings can move in any diagonal direction
-            int directions[] = {-1, 1};
-            for (int dr : directions) {
-                for (int dc : directions) {
-                    if (isValidMove(piece, row + dr, col + dc))
-                        return true;
-                }
-            }
-        } else {
-            // Regular pieces can only move forward (based on color)
-            int forwardDir = (color == PieceColor::Red) ? 1 : -1;
-            int dcOptions[] = {-1, 1};
-            for (int dc : dcOptions) {
-                if (isValidMove(piece, row + forwardDir, col + dc))
-                    return true;
-            }
-        }
-    }
+/**
+ * @brief Lists every legal move for a color as complete move sequences.
+ * 
+ * Enforces mandatory capture, and while a multi-jump is in progress only
+ * the continuations of that capture sequence are legal.
+ * 
+ * @param color The color to generate moves for.
+ * @param moves Output list of moves.
+ */
+void CheckersBoard::getLegalMoves(PieceColor color, MoveList &moves)
+{
+    Position pos = getPosition(color);
 
-    // No valid move found
-    return false;
+    if (m_chainSquare >= 0 && color == currentTurn)
+        generateJumpsFrom(pos, m_chainSquare, moves);
+    else
+        generateMoves(pos, moves);
 }
 
 /**
  * @brief Checks if a given move for a piece is valid.
  * 
- * Handles basic move rules, prevents backward moves for non-kings,
- * and checks square occupation and capture conditions.
+ * A move is valid if it is the first hop of one of the legal moves produced
+ * by the move generator, so mandatory captures and multi-jump continuations
+ * are enforced here too.
  * 
  * @param piece The piece to move.
  * @param newRow The row to move to.
@@ -317,48 +308,23 @@ bool CheckersBoard::isValidMove(Piece *piece, int newRow, int newCol)
         return false;
     }
 
-    // Checks if destination is occupied
-    for (QGraphicsItem *item : m_scene->items()) {
-        Piece *otherPiece = dynamic_cast<Piece *>(item);
-        if (otherPiece && otherPiece->getRow() == newRow && otherPiece->getCol() == newCol) {
-            return false;
-        }
-    }
-
-    // Gathers movement deltas
-    int oldRow = piece->getRow();
-    int oldCol = piece->getCol();
-    int rowDiff = newRow - oldRow;
-    int colDiff = abs(newCol - oldCol);
-
-    // Prevents backward movement for non-king pieces
-    if (!piece->isKing()) {
-        if (piece->getColor() == PieceColor::Red && rowDiff <= 0) {
-            return false;
-        }
-        if (piece->getColor() == PieceColor::Black && rowDiff >= 0) {
-            return false;
-        }
-    }
-
-    // Valid 1-step king move
-    if (piece->isKing() && abs(rowDiff) == 1 && colDiff == 1) {
-        return true;
+    // Both squares must be playable
+    int from = squareOf(piece->getRow(), piece->getCol());
+    int to = squareOf(newRow, newCol);
+    if (from < 0 || to < 0) {
+        return false;
     }
 
-    // Valid 1-step move (non-capture)
-    if (abs(rowDiff) == 1 && colDiff == 1) {
-        for (QGraphicsItem *item : m_scene->items()) {
-            Piece *otherPiece = dynamic_cast<Piece *>(item);
-            if (otherPiece && otherPiece->getRow() == newRow && otherPiece->getCol() == newCol) {
-                return false;
-            }
+    // Look for a legal move that starts with this hop
+    MoveList moves;
+    getLegalMoves(piece->getColor(), moves);
+    for (const Move &move : moves) {
+        if (move.from == from && move.firstLanding() == to) {
+            return true;
         }
-        return true;
     }
 
-    // If not a normal move, check if it's a valid capture
-    return isCaptureMove(piece, newRow, newCol);
+    return false;
 }
 
 /**
@@ -375,49 +341,28 @@ bool CheckersBoard::isCaptureMove(Piece *piece, int newRow, int newCol)
 {
     if (!piece) return false;
 
-    // Ensure target position is within board bounds
-    if (newRow < 0 || newRow >= BOARD_SIZE || newCol < 0 || newCol >= BOARD_SIZE) {
+    // Ensure both squares are playable and on the board
+    int from = squareOf(piece->getRow(), piece->getCol());
+    int to = squareOf(newRow, newCol);
+    if (from < 0 || to < 0) {
         return false;
     }
 
-    int oldRow = piece->getRow();
-    int oldCol = piece->getCol();
-    int rowDiff = newRow - oldRow;
-    int colDiff = newCol - oldCol;
-
-    // Prevent backward captures for non-kings
-    if (!piece->isKing()) {
-        if (piece->getColor() == PieceColor::Red && rowDiff <= 0)
-            return false;
-        if (piece->getColor() == PieceColor::Black && rowDiff >= 0)
-            return false;
-    }
-
-    // Check if move is a jump of 2 squares in both row and column
-    if (abs(rowDiff) == 2 && abs(colDiff) == 2) {
-        int midRow = (oldRow + newRow) / 2;
-        int midCol = (oldCol + newCol) / 2;
-
-        // Confirm midpoint is within bounds
-        if (midRow < 0 || midRow >= BOARD_SIZE || midCol < 0 || midCol >= BOARD_SIZE) {
-            return false;
-        }
+    // Find the jump direction that lands on the target
+    // (non-kings can't capture backwards)
+    Side side = toSide(piece->getColor());
+    for (int dir = firstDirection(side, piece->isKing()); dir < lastDirection(side, piece->isKing()); ++dir) {
+        if (MOVE_TABLES.jumpLand[from][dir] != to)
+            continue;
 
         // Check destination is unoccupied
-        for (QGraphicsItem *item : m_scene->items()) {
-            Piece *landingPiece = dynamic_cast<Piece *>(item);
-            if (landingPiece && landingPiece->getRow() == newRow && landingPiece->getCol() == newCol)
-                return false;
-        }
+        if (getPieceAt(newRow, newCol))
+            return false;
 
         // Check if opponent piece exists at midpoint
-        for (QGraphicsItem *item : m_scene->items()) {
-            Piece *midPiece = dynamic_cast<Piece *>(item);
-            if (midPiece && midPiece->getRow() == midRow && midPiece->getCol() == midCol) {
-                if (midPiece->getColor() != piece->getColor())
-                    return true;
-            }
-        }
+        int over = MOVE_TABLES.jumpOver[from][dir];
+        Piece *midPiece = getPieceAt(rowOf(over), colOf(over));
+        return midPiece && midPiece->getColor() != piece->getColor();
     }
 
     return false;
@@ -435,18 +380,14 @@ bool CheckersBoard::isCaptureAvailable(Piece *piece)
 {
     if (!piece) return false;
 
-    int row = piece->getRow();
-    int col = piece->getCol();
-    int possibleDirections[] = {-2, 2}; // Capture jump distances
-
-    // Check all possible capture directions
-    for (int dr : possibleDirections) {
-        for (int dc : possibleDirections) {
-            int targetRow = row + dr;
-            int targetCol = col + dc;
-            if (isCaptureMove(piece, targetRow, targetCol))
-                return true;
-        }
+    int square = squareOf(piece->getRow(), piece->getCol());
+    if (square < 0) return false;
+
+    // Check the landing square of every jump direction
+    for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+        int land = MOVE_TABLES.jumpLand[square][dir];
+        if (land >= 0 && isCaptureMove(piece, rowOf(land), colOf(land)))
+            return true;
     }
 
     return false;
@@ -462,9 +403,7 @@ bool CheckersBoard::isCaptureAvailable(Piece *piece)
 bool CheckersBoard::isAnyCaptureAvailable()
 {
     // Loop through all board pieces
-    for (QGraphicsItem *item : m_scene->items()) {
-        Piece *piece = dynamic_cast<Piece *>(item);
-
+    for (Piece *piece : m_pieces) {
         // Check only current player's pieces
         if (piece && piece->getColor() == currentTurn && isCaptureAvailable(piece))
             return true;
@@ -506,9 +445,8 @@ bool CheckersBoard::checkwin(PieceColor color)
 QList<Piece*> CheckersBoard::getPieces(PieceColor color) {
     QList<Piece*> piecesList;
 
-    // Loop through all items and filter pieces by color
-    for (QGraphicsItem *item : m_scene->items()) {
-        Piece *piece = dynamic_cast<Piece*>(item);
+    // Loop through the occupied squares and filter pieces by color
+    for (Piece *piece : m_pieces) {
         if (piece && piece->getColor() == color)
             piecesList.push_back(piece);
     }
@@ -542,9 +480,8 @@ QList<Piece*> CheckersBoard::getOpponentPieces() {
  * @return Pointer to the piece if found, nullptr otherwise.
  */
 Piece* CheckersBoard::getPieceById(int id) {
-    // Loop through scene items and match piece ID
-    for (QGraphicsItem *item : m_scene->items()) {
-        Piece *piece = dynamic_cast<Piece*>(item);
+    // Loop through the occupied squares and match piece ID
+    for (Piece *piece : m_pieces) {
         if (piece && piece->getId() == id) {
             return piece;
         }
@@ -574,37 +511,83 @@ CheckersBoard* CheckersBoard::clone() const {
             delete item;
         }
     }
+    std::fill(std::begin(newBoard->m_pieces), std::end(newBoard->m_pieces), nullptr);
 
     // Copy actual pieces from current board to the new one
-    for (QGraphicsItem *item : m_scene->items()) {
-        Piece *piece = dynamic_cast<Piece*>(item);
+    for (Piece *piece : m_pieces) {
         if (piece) {
             Piece *newPiece = new Piece(piece->getColor(), piece->isKing(), piece->getRow(), piece->getCol());
             newPiece->setId(piece->getId());
             newBoard->m_scene->addItem(newPiece);
+            newBoard->placePiece(newPiece, piece->getRow(), piece->getCol());
         }
     }
 
     return newBoard;
 }
 
+/**
+ * @brief Snapshots the current pieces into a Qt-free bitboard Position.
+ * 
+ * Used by the AI so the search never has to touch scene items.
+ * 
+ * @param sideToMove The color whose turn it is in the snapshot.
+ * @return Position holding every red and black piece.
+ */
+Position CheckersBoard::getPosition(PieceColor sideToMove)
+{
+    Position pos;
+    pos.sideToMove = (sideToMove == PieceColor::Red) ? Side::Red : Side::Black;
+
+    for (int square = 0; square < NUM_SQUARES; ++square) {
+        Piece *piece = m_pieces[square];
+        if (!piece) continue;
+
+        if (piece->getColor() == PieceColor::Red)
+            pos.setPiece(square, Side::Red, piece->isKing());
+        else if (piece->getColor() == PieceColor::Black)
+            pos.setPiece(square, Side::Black, piece->isKing());
+    }
+
+    return pos;
+}
+
 /**
  * @brief Returns the piece located at a specific row and column.
  * 
- * @param row Board row to search.
- * @param col Board column to search.
- * @return Pointer to the matching piece, or nullptr if none found.
+ * Reads the occupancy array kept up to date by every move, undo and setup.
+ * 
+ * @param row Board row to look at.
+ * @param col Board column to look at.
+ * @return Pointer to the piece there, or nullptr if the square is empty or not playable.
  */
 Piece* CheckersBoard::getPieceAt(int row, int col)
 {
-    // Loop through all items in the scene
-    for (QGraphicsItem *item : m_scene->items()) {
-        Piece *piece = dynamic_cast<Piece*>(item);
-        if (piece && piece->getRow() == row && piece->getCol() == col)
-            return piece;
-    }
+    int square = squareOf(row, col);
+    return (square >= 0) ? m_pieces[square] : nullptr;
+}
 
-    return nullptr;
+/**
+ * @brief Puts a piece on a square of the occupancy array and centres it there on screen.
+ * 
+ * Clears the square the piece came from if the array still holds it there.
+ * 
+ * @param piece The piece to place.
+ * @param row Target row.
+ * @param col Target column.
+ */
+void CheckersBoard::placePiece(Piece *piece, int row, int col)
+{
+    int oldSquare = squareOf(piece->getRow(), piece->getCol());
+    if (oldSquare >= 0 && m_pieces[oldSquare] == piece)
+        m_pieces[oldSquare] = nullptr;
+
+    piece->setBoardPosition(row, col);
+    m_pieces[squareOf(row, col)] = piece;
+
+    qreal x = col * CELL_SIZE + (CELL_SIZE - piece->pixmap().width()) / 2.0;
+    qreal y = row * CELL_SIZE + (CELL_SIZE - piece->pixmap().height()) / 2.0;
+    piece->setPos(x, y);
 }
 
 /**
@@ -652,6 +635,8 @@ void CheckersBoard::initializeBoard() {
                 square->setBrush(QColor(222, 184, 135)); // Light wood
 
             m_scene->addItem(square);
+            if (squareOf(row, col) >= 0)
+                m_squares[squareOf(row, col)] = square;
         }
     }    
 }
@@ -671,9 +656,7 @@ void CheckersBoard::initializePieces()
             if ((row + col) % 2 == 0) {  // Place only on dark squares
                 Piece *redPiece = new Piece(PieceColor::Red, false, row, col);
                 // Center the piece inside the square
-                qreal x = col * CELL_SIZE + (CELL_SIZE - redPiece->pixmap().width()) / 2.0;
-                qreal y = row * CELL_SIZE + (CELL_SIZE - redPiece->pixmap().height()) / 2.0;
-                redPiece->setPos(x, y);
+                placePiece(redPiece, row, col);
                 m_scene->addItem(redPiece);
             }
         }
@@ -684,9 +667,7 @@ void CheckersBoard::initializePieces()
         for (int col = 0; col < BOARD_SIZE; ++col) {
             if ((row + col) % 2 == 0) {
                 Piece *blackPiece = new Piece(PieceColor::Black, false, row, col);
-                qreal x = col * CELL_SIZE + (CELL_SIZE - blackPiece->pixmap().width()) / 2.0;
-                qreal y = row * CELL_SIZE + (CELL_SIZE - blackPiece->pixmap().height()) / 2.0;
-                blackPiece->setPos(x, y);
+                placePiece(blackPiece, row, col);
                 m_scene->addItem(blackPiece);
             }
         }
@@ -705,20 +686,18 @@ void CheckersBoard::undoLastMove()
     }
 
     // Pop the last move from history
-    MoveRecord record = moveHistory.top();
-    moveHistory.pop();
+    MoveRecord record = moveHistory.back();
+    moveHistory.pop_back();
+    m_chainSquare = -1;
 
-    // Get the piece that was moved
-    Piece* piece = getPieceById(record.pieceId);
-    if (!piece) {
+    // Get the piece that was moved (it is still on the square it moved to)
+    Piece* piece = getPieceAt(record.newRow, record.newCol);
+    if (!piece || piece->getId() != record.pieceId) {
         return;
     }
 
     // Move the piece back to its old position
-    piece->setBoardPosition(record.oldRow, record.oldCol);
-    qreal x = record.oldCol * CELL_SIZE + (CELL_SIZE - piece->pixmap().width()) / 2.0;
-    qreal y = record.oldRow * CELL_SIZE + (CELL_SIZE - piece->pixmap().height()) / 2.0;
-    piece->setPos(x, y);
+    placePiece(piece, record.oldRow, record.oldCol);
 
     // If it was promoted, revert it
     if (record.wasPromoted) {
@@ -729,9 +708,7 @@ void CheckersBoard::undoLastMove()
     if (record.captureOccurred) {
         Piece* capturedPiece = new Piece(record.capturedColor, record.capturedWasKing, record.capturedRow, record.capturedCol);
         capturedPiece->setId(record.capturedPieceId);
-        qreal cx = record.capturedCol * CELL_SIZE + (CELL_SIZE - capturedPiece->pixmap().width()) / 2.0;
-        qreal cy = record.capturedRow * CELL_SIZE + (CELL_SIZE - capturedPiece->pixmap().height()) / 2.0;
-        capturedPiece->setPos(cx, cy);
+        placePiece(capturedPiece, record.capturedRow, record.capturedCol);
         m_scene->addItem(capturedPiece);
     }
 
@@ -741,6 +718,45 @@ void CheckersBoard::undoLastMove()
     emit gameCheck();
 }
 
+/**
+ * @brief Undoes the most recent turn as a whole.
+ * 
+ * A multi-jump is recorded one hop at a time, so every record the same side
+ * played in a row is taken back, including a capture still in progress.
+ * 
+ * @return The color that played the undone turn.
+ */
+PieceColor CheckersBoard::undoLastTurn()
+{
+    PieceColor mover = currentTurn;
+    if (moveHistory.empty()) {
+        return mover;
+    }
+
+    mover = moveHistory.back().mover;
+    while (!moveHistory.empty() && moveHistory.back().mover == mover) {
+        undoLastMove();
+    }
+    forceTurn(mover);
+
+    return mover;
+}
+
+/**
+ * @brief Checks if a color has any move in the undo history.
+ * 
+ * @param color The color to look for.
+ * @return true if undoing turns would reach one of its moves.
+ */
+bool CheckersBoard::hasPlayedTurn(PieceColor color) const
+{
+    for (const MoveRecord &record : moveHistory) {
+        if (record.mover == color)
+            return true;
+    }
+    return false;
+}
+
 /**
  * @brief Highlights all valid destination squares for the selected piece.
  * 
@@ -749,36 +765,33 @@ void CheckersBoard::undoLastMove()
  * @param piece Pointer to the piece to check moves for.
  */
 void CheckersBoard::highlightValidMoves(Piece* piece) {
+    TRACE_SCOPE("CheckersBoard::highlightValidMoves");
     clearHighlightedSquares(); // Clear previous highlights
 
-    for (QGraphicsItem* item : m_scene->items()) {
-        BoardSquare* square = dynamic_cast<BoardSquare*>(item);
-        if (!square) continue;
-
-        int row = square->getRow();
-        int col = square->getCol();
+    if (!piece) return;
+    int from = squareOf(piece->getRow(), piece->getCol());
+
+    // Collect the first hop of every legal move that starts with this piece
+    uint32_t targets = 0;
+    uint32_t captureTargets = 0;
+    MoveList moves;
+    getLegalMoves(piece->getColor(), moves);
+    for (const Move &move : moves) {
+        if (move.from != from) continue;
+        targets |= bit(move.firstLanding());
+        if (move.jumps > 0)
+            captureTargets |= bit(move.firstLanding());
+    }
 
-        bool isCapture = isCaptureMove(piece, row, col);
-        bool isValid = isValidMove(piece, row, col);
+    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
+        BoardSquare* square = m_squares[sq];
+        if (!square || !(targets & bit(sq))) continue;
 
-        // Multi-capture scenario
-        if (selectedPiece == piece) {
-            if (isCapture) {
-                square->setBrush(QColor(0, 100, 0)); // Dark green
-                m_highlightedSquares.append(square);
-            } else if (isValid) {
-                square->setBrush(Qt::green); // Light green
-                m_highlightedSquares.append(square);
-            }
-        }
-        // Regular move
-        else if (!selectedPiece && isValid) {
-            if (isCapture)
-                square->setBrush(QColor(0, 100, 0));
-            else
-                square->setBrush(Qt::green);
-            m_highlightedSquares.append(square);
-        }
+        if (captureTargets & bit(sq))
+            square->setBrush(QColor(0, 100, 0)); // Dark green
+        else
+            square->setBrush(Qt::green);         // Light green
+        m_highlightedSquares.append(square);
     }
 }
 
@@ -19,14 +19,17 @@
 #include <QGraphicsItem>
 #include <QGraphicsScene>
 #include <QList>
-#include <stack>
+#include <vector>
 #include "piece.h"  // Defines Piece and PieceColor
+#include "Position.h" // Bitboard snapshot used by the AI
+#include "MoveGen.h"  // Legal-move generator shared with the AI
 
 /**
  * @struct MoveRecord
  * @brief Stores a complete move history record for undo functionality.
  */
 struct MoveRecord {
+    PieceColor mover;        // Side that played the hop
     int pieceId;
     int oldRow, oldCol;
     int newRow, newCol;
@@ -98,10 +101,15 @@ public:
     QList<Piece*> getAIPieces();                            // Returns AI pieces.
     QList<Piece*> getOpponentPieces();                      // Returns pieces of the non-current turn.
 
-    void undoLastMove();                                    // Undoes the most recent move.
+    void undoLastMove();                                    // Undoes the most recent move (one hop of a multi-jump).
+    PieceColor undoLastTurn();                              // Undoes every hop of the most recent turn.
+    bool hasPlayedTurn(PieceColor color) const;             // Checks if a color has a move that can be undone.
     void highlightValidMoves(Piece* piece);                 // Highlights valid squares for a given piece.
     void clearHighlightedSquares();                         // Clears highlighted squares.
 
+    Position getPosition(PieceColor sideToMove);            // Snapshots the pieces as a bitboard Position.
+    void getLegalMoves(PieceColor color, MoveList &moves);  // Lists every legal move (full capture sequences).
+
 signals:
     void moveCompleted();         // Emitted when a move is completed.
     void gameCheck();             // Emitted when a check state occurs.
@@ -114,9 +122,12 @@ private:
     QGraphicsScene *m_scene;                // Graphics scene for rendering.
     Piece *selectedPiece;                   // Currently selected piece.
     PieceColor currentTurn = PieceColor::Black; // Whose turn it is.
-    std::stack<MoveRecord> moveHistory;     // Stack for undo functionality.
+    std::vector<MoveRecord> moveHistory;    // Stack of hops for undo functionality.
     QList<BoardSquare*> m_highlightedSquares;// Squares currently highlighted.
     bool m_captureMade = false;             // Flag if a capture was made.
+    int m_chainSquare = -1;                 // Square of a piece partway through a multi-jump (-1 if none).
+    Piece *m_pieces[NUM_SQUARES] = {};      // Piece on each playable square (nullptr if empty).
+    BoardSquare *m_squares[NUM_SQUARES] = {}; // Scene item of each playable square.
 
     /**
      * @brief Checks if a piece belongs to the current player.
@@ -125,6 +136,7 @@ private:
 
     void initializeBoard();                 // Sets up the board squares.
     void initializePieces();                // Places the pieces on the board.
+    void placePiece(Piece *piece, int row, int col); // Moves a piece in the occupancy array and on screen.
 };
 
 #endif // CHECKERSBOARD_H
\ No newline at end of file
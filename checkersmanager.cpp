@@ -10,6 +10,7 @@
  */
 
 #include "checkersmanager.h"
+#include "Trace.h"
 #include <QTimer>
 
 /**
@@ -22,6 +23,25 @@ CheckersManager::CheckersManager(QObject *parent) : QObject(parent)
     gameOver = false;
 }
 
+/**
+ * @brief Destructor for CheckersManager.
+ * 
+ * Stops a running search and waits for the AI thread to exit, so the worker
+ * never outlives the AI it searches for, then deletes the players (and with
+ * them the AI's hash table, tablebases, book and network).
+ */
+CheckersManager::~CheckersManager()
+{
+    cancelAIMove();
+    aiThread.quit();
+    aiThread.wait();  // The worker is deleted as the thread finishes
+
+    // In PvAI mode player2 is the AI
+    delete player1;
+    delete player2;
+    aiPlayer = nullptr;
+}
+
 /**
  * @brief Starts a new game with provided settings.
  * 
@@ -48,6 +68,18 @@ void CheckersManager::onStart(int numPlayers, const QString &difficulty, bool sh
         int difficultyLevel = (difficulty == "Easy") ? 1 : (difficulty == "Medium") ? 2 : 3;
         aiPlayer = new AI(difficultyLevel, board->getPieces(PieceColor::Red));
         player2 = aiPlayer;
+
+        // Searching difficulties think on a worker thread so the window never freezes
+        if (aiPlayer->usesSearch()) {
+            aiWorker = new AIWorker(aiPlayer);
+            aiWorker->moveToThread(&aiThread);
+            connect(&aiThread, &QThread::finished, aiWorker, &QObject::deleteLater);
+            connect(this, &CheckersManager::aiSearchRequested, aiWorker, &AIWorker::search);
+            connect(this, &CheckersManager::aiPonderRequested, aiWorker, &AIWorker::ponder);
+            connect(aiWorker, &AIWorker::moveFound, this, &CheckersManager::onAIMoveFound);
+            connect(aiWorker, &AIWorker::searchInfo, this, &CheckersManager::onAISearchInfo);
+            aiThread.start();
+        }
     } else {
         // PvP mode
         player2 = new Player("Player 2", board->getPieces(PieceColor::Red));
@@ -57,7 +89,8 @@ void CheckersManager::onStart(int numPlayers, const QString &difficulty, bool sh
 /**
  * @brief Makes the AI play a move if it's its turn.
  * 
- * Executes AI move using a delayed QTimer.
+ * Executes AI move using a delayed QTimer. Medium and Hard search on the AI
+ * thread and answer through onAIMoveFound(); Easy picks its move right away.
  */
 void CheckersManager::makeAIMove()
 {
@@ -67,18 +100,103 @@ void CheckersManager::makeAIMove()
 
     // Only proceed if AI exists and it's its turn
     if (aiPlayer && board->getCurrentTurn() == PieceColor::Red) {
+        // The user has moved: end pondering so the worker is free for the real search
+        aiPlayer->stopSearch();
+        int requestId = ++aiRequestId;
 
         // Delay the move slightly for UI responsiveness
         QTimer::singleShot(50, this, [=]() {
+            // Cancelled in the meantime, or no longer the AI's turn
+            if (requestId != aiRequestId || gameOver || board->getCurrentTurn() != PieceColor::Red) {
+                return;
+            }
+
+            if (aiWorker) {
+                // Hand a snapshot to the worker; the board stays on this thread
+                Position pos = board->getPosition(PieceColor::Red);
+                MoveList rootMoves;
+                board->getLegalMoves(PieceColor::Red, rootMoves);
+                emit aiSearchRequested(requestId, pos, rootMoves, aiPlayer->stopToken());
+                return;
+            }
+
             auto bestMove = aiPlayer->getBestMove(*board);
             if (bestMove.first) {
                 board->handleMove(bestMove.first, bestMove.second.first, bestMove.second.second);
-            } else {
             }
         });
     }
 }
 
+/**
+ * @brief Plays the AI worker's move on the board.
+ * 
+ * Answers to cancelled requests are dropped: the board may have changed
+ * (undo, new game) since the snapshot was taken.
+ * 
+ * @param requestId Id of the request the move answers.
+ * @param move The move chosen by the search.
+ */
+void CheckersManager::onAIMoveFound(int requestId, Move move)
+{
+    if (requestId != aiRequestId || gameOver || board->getCurrentTurn() != PieceColor::Red) {
+        return;
+    }
+
+    auto bestMove = aiPlayer->toBoardMove(*board, move);
+    if (bestMove.first) {
+        board->handleMove(bestMove.first, bestMove.second.first, bestMove.second.second);
+    }
+
+    // Once the whole move has landed, think on the user's time
+    if (!gameOver && board->getCurrentTurn() == PieceColor::Black) {
+        startPondering();
+    }
+}
+
+/**
+ * @brief Forwards a progress report of the current AI search to the UI.
+ * 
+ * @param requestId Id of the request the report belongs to.
+ * @param info The report.
+ */
+void CheckersManager::onAISearchInfo(int requestId, SearchInfo info)
+{
+    if (requestId != aiRequestId || gameOver) {
+        return;
+    }
+    emit searchInfoUpdated(info);
+}
+
+/**
+ * @brief Sends the user's position to the worker to ponder on.
+ * 
+ * The worker stays busy until the next stopSearch(), which comes from the
+ * user's move, an undo, the end of the game or leaving the game.
+ */
+void CheckersManager::startPondering()
+{
+    if (!ponderEnabled || !aiWorker) {
+        return;
+    }
+
+    emit aiPonderRequested(board->getPosition(PieceColor::Black), aiPlayer->stopToken());
+}
+
+/**
+ * @brief Cancels the pending AI move, if any.
+ * 
+ * Bumping the request id makes both the delayed timer and a late worker
+ * answer no-ops; stopping the search (or pondering) frees the worker right away.
+ */
+void CheckersManager::cancelAIMove()
+{
+    ++aiRequestId;
+    if (aiPlayer) {
+        aiPlayer->stopSearch();
+    }
+}
+
 /**
  * @brief Checks the win condition for both sides.
  * 
@@ -86,6 +204,7 @@ void CheckersManager::makeAIMove()
  */
 void CheckersManager::checkWinCondition()
 {
+    TRACE_SCOPE("CheckersManager::checkWinCondition");
     if (!board) return;
 
     bool redHasMoves = board->hasValidMoves(PieceColor::Red);
@@ -94,6 +213,11 @@ void CheckersManager::checkWinCondition()
     int redCount = board->getPieces(PieceColor::Red).size();
     int blackCount = board->getPieces(PieceColor::Black).size();
 
+    // Nothing left to think about once the game is decided
+    if (!redHasMoves || !blackHasMoves) {
+        cancelAIMove();
+    }
+
     // Stalemate: no valid moves for both sides
     if (!redHasMoves && !blackHasMoves) {
         if (redCount > blackCount) {
@@ -128,26 +252,48 @@ void CheckersManager::setBoard(CheckersBoard *board)
     this->board = board;
 }
 
+/**
+ * @brief Takes back whole turns until one of the given side's own turns is undone.
+ * 
+ * Undoes the opponent's reply (or the part of it played so far) and then the
+ * side's own last turn, multi-jumps included, and gives the side the move.
+ * 
+ * @param side The side asking for the undo.
+ * @return false if the side has no turn to take back; nothing is undone then.
+ */
+bool CheckersManager::undoTurnsOf(PieceColor side)
+{
+    if (!board->hasPlayedTurn(side)) {
+        return false;
+    }
+
+    PieceColor undone;
+    do {
+        undone = board->undoLastTurn();  // Leaves the turn with the side that played it
+    } while (undone != side);
+    return true;
+}
+
 /**
  * @brief Undoes the last move or pair of moves, depending on mode.
  * 
- * In PvAI: undoes both AI and player move. In PvP: undo last two player moves.
+ * In PvAI: undoes the AI's reply, even one still being searched or played,
+ * and the user's last move. In PvP: undoes the opponent's last move and the
+ * current player's previous move.
  */
 void CheckersManager::undoMove()
 {
     if (!board || gameOver) return;
 
+    // Never let a search started before the undo play on the restored board
+    cancelAIMove();
+
     if (aiPlayer) {
         // PvAI Mode — only the user (Black) can undo
-        if (userUndosLeft <= 0) {
+        if (userUndosLeft <= 0 || !undoTurnsOf(PieceColor::Black)) {
             return;
         }
 
-        // Undo AI move + user move
-        board->undoLastMove();  // Undo AI's move
-        board->undoLastMove();  // Undo user's move
-        board->forceTurn(PieceColor::Black); // Force back to user
-
         userUndosLeft--;
         emit userUndoCountUpdated(userUndosLeft); // Update UI
         return;
@@ -157,25 +303,17 @@ void CheckersManager::undoMove()
     PieceColor current = board->getCurrentTurn();
 
     if (current == PieceColor::Red) {
-        if (redUndosLeft <= 0) {
+        if (redUndosLeft <= 0 || !undoTurnsOf(PieceColor::Red)) {
             return;
         }
 
-        board->undoLastMove();  // Undo Black's last move
-        board->undoLastMove();  // Undo Red's previous move
-        board->forceTurn(PieceColor::Red);
-
         redUndosLeft--;
         emit undoCountsUpdated(redUndosLeft, blackUndosLeft);
     } else {
-        if (blackUndosLeft <= 0) {
+        if (blackUndosLeft <= 0 || !undoTurnsOf(PieceColor::Black)) {
             return;
         }
 
-        board->undoLastMove();  // Undo Red's last move
-        board->undoLastMove();  // Undo Black's previous move
-        board->forceTurn(PieceColor::Black);
-
         blackUndosLeft--;
         emit undoCountsUpdated(redUndosLeft, blackUndosLeft);
     }
@@ -13,9 +13,11 @@
 #define CHECKERSMANAGER_H
 
 #include <QObject>
+#include <QThread>
 #include "checkersboard.h"
 #include "Player.h"
 #include "AI.h"
+#include "AIWorker.h"
 
 /**
  * @class CheckersManager
@@ -28,9 +30,25 @@ class CheckersManager : public QObject {
 
 private:
     CheckersBoard *board;    // Pointer to the main game board
-    Player *player1;         // First player (usually human)
-    Player *player2;         // Second player (can be AI or human)
-    AI *aiPlayer;            // AI logic handler (used in PvAI mode)
+    Player *player1 = nullptr; // First player (usually human); owned
+    Player *player2 = nullptr; // Second player (can be AI or human); owned
+    AI *aiPlayer = nullptr;  // AI logic handler (used in PvAI mode); same object as player2
+
+    QThread aiThread;                // Thread the AI searches on (Medium/Hard)
+    AIWorker *aiWorker = nullptr;    // Runs the search; lives on aiThread
+    int aiRequestId = 0;             // Id of the AI move currently wanted; bumped to cancel
+    bool ponderEnabled = true;       // Let the AI search on the user's time (PvAI, Medium/Hard)
+
+    /**
+     * @brief Starts pondering on the user's position once the AI's move has landed.
+     */
+    void startPondering();
+
+    /**
+     * @brief Takes back whole turns until one of the side's own turns is undone.
+     * @return false if the side has no turn to take back.
+     */
+    bool undoTurnsOf(PieceColor side);
 
     bool gameOver = false;   // Tracks whether the game has ended
 
@@ -44,6 +62,11 @@ public:
      */
     explicit CheckersManager(QObject *parent = nullptr);
 
+    /**
+     * @brief Stops any running search and shuts down the AI thread.
+     */
+    ~CheckersManager();
+
     /**
      * @brief Assigns the board instance to the manager.
      * @param board Pointer to an existing CheckersBoard.
@@ -74,6 +97,28 @@ signals:
      */
     void userUndoCountUpdated(int remaining);
 
+    /**
+     * @brief Asks the AI worker to search a board snapshot (queued to the AI thread).
+     * @param requestId Id of the request; answers to older ids are ignored.
+     * @param pos Snapshot of the board with Red to move.
+     * @param rootMoves Red's legal moves in that snapshot.
+     * @param token AI stop token read when the request was made.
+     */
+    void aiSearchRequested(int requestId, Position pos, MoveList rootMoves, unsigned token);
+
+    /**
+     * @brief Asks the AI worker to ponder on the user's position (queued to the AI thread).
+     * @param pos Snapshot of the board with Black to move.
+     * @param token AI stop token read when the request was made.
+     */
+    void aiPonderRequested(Position pos, unsigned token);
+
+    /**
+     * @brief Emitted after every iteration of the AI's search for its current move.
+     * @param info Depth, nodes, rates, score (for the AI) and PV so far.
+     */
+    void searchInfoUpdated(SearchInfo info);
+
 public slots:
     /**
      * @brief Starts a new game with the given configuration.
@@ -105,6 +150,26 @@ public slots:
      * @brief Undoes the last move, if allowed.
      */
     void undoMove();
+
+    /**
+     * @brief Cancels any pending or running AI move (undo, "Play Again", back to menu).
+     */
+    void cancelAIMove();
+
+private slots:
+    /**
+     * @brief Plays the move found by the AI worker, unless the request was cancelled.
+     * @param requestId Id of the request the move answers.
+     * @param move The move chosen by the search.
+     */
+    void onAIMoveFound(int requestId, Move move);
+
+    /**
+     * @brief Passes on the worker's progress report, unless the request was cancelled.
+     * @param requestId Id of the request the report belongs to.
+     * @param info The report.
+     */
+    void onAISearchInfo(int requestId, SearchInfo info);
 };
 
 #endif // CHECKERSMANAGER_H
\ No newline at end of file
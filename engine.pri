@@ -0,0 +1,41 @@
+# Engine sources shared by the game and the offline tools (no Qt dependency)
+
+INCLUDEPATH += $$PWD
+
+# Evaluation weights compiled in: the defaults, or a tuned file given with
+# qmake "EVAL_PARAMS=/path/to/params.h"
+isEmpty(EVAL_PARAMS): EVAL_PARAMS = $$PWD/EvalParams.h
+DEFINES += EVAL_PARAMS_FILE=\\\"$$EVAL_PARAMS\\\"
+
+SOURCES += \
+    $$PWD/MappedFile.cpp\
+    $$PWD/MiniMaxAlgo.cpp\
+    $$PWD/MoveOrder.cpp\
+    $$PWD/Nnue.cpp\
+    $$PWD/OpeningBook.cpp\
+    $$PWD/Pdn.cpp\
+    $$PWD/Position.cpp\
+    $$PWD/MoveGen.cpp\
+    $$PWD/TranspositionTable.cpp\
+    $$PWD/Tablebase.cpp\
+    $$PWD/TablebaseProbe.cpp\
+    $$PWD/Trace.cpp
+
+HEADERS += \
+    $$PWD/EvalParams.h\
+    $$PWD/EvalTables.h\
+    $$PWD/Evaluation.h\
+    $$PWD/MappedFile.h\
+    $$PWD/MiniMaxAlgo.h\
+    $$PWD/MoveOrder.h\
+    $$PWD/Nnue.h\
+    $$PWD/OpeningBook.h\
+    $$PWD/MoveTables.h\
+    $$PWD/MoveGen.h\
+    $$PWD/Pdn.h\
+    $$PWD/Position.h\
+    $$PWD/TranspositionTable.h\
+    $$PWD/Tablebase.h\
+    $$PWD/TablebaseProbe.h\
+    $$PWD/Trace.h\
+    $$PWD/Zobrist.h
@@ -15,6 +15,7 @@
 #include <QDebug>
 #include "mainwindow.h"
 #include "stylehelpers.h"
+#include "Pdn.h"
 #include <QMessageBox>
 
 /**
@@ -90,6 +91,13 @@ GamePage::GamePage(QWidget *gameWidget, const QString &gameTitle, QWidget *paren
     undoBar->addWidget(redUndosLabel);
     undoBar->addWidget(blackUndosLabel);
 
+    // -------------------- Engine Panel --------------------
+    engineInfoLabel = new QLabel(this);
+    engineInfoLabel->setStyleSheet("font-size: 14px; color: black; background-color: white; border: 1px solid black; padding: 6px;");
+    engineInfoLabel->setWordWrap(true);
+    engineInfoLabel->setFixedWidth(gameWidget->width());  // As wide as the board
+    engineInfoLabel->hide();
+
     // -------------------- Undo Button --------------------
     undoButton = new QPushButton("Undo", this);
     undoButton->setFixedSize(130, 60);
@@ -131,6 +139,7 @@ GamePage::GamePage(QWidget *gameWidget, const QString &gameTitle, QWidget *paren
     layout->addLayout(titleArea);
     layout->addSpacing(20);
     layout->addWidget(boardWrapper, 0, Qt::AlignCenter);
+    layout->addWidget(engineInfoLabel, 0, Qt::AlignCenter);
     layout->addSpacing(20);
     layout->addLayout(bottomBar);
     setLayout(layout);
@@ -185,6 +194,29 @@ void GamePage::updateTurnIndicator(PieceColor newTurn)
     ).arg(color));
 }
 
+/**
+ * @brief Shows the AI's depth, score, node counts, rates and expected line.
+ */
+void GamePage::updateEngineInfo(const SearchInfo &info)
+{
+    QString pv;
+    for (const Move &move : info.pv)
+        pv += QString::fromStdString(pdnMoveText(move)) + " ";
+
+    engineInfoLabel->setText(QString(
+        "AI: depth %1/%2   score %3   %4M nodes   %5M nodes/s\n"
+        "TT hits %6%   first-move cutoffs %7%\n"
+        "Line: %8"
+    ).arg(info.depth).arg(info.seldepth)
+     .arg(info.score > 0 ? QString("+%1").arg(info.score) : QString::number(info.score))
+     .arg(info.nodes / 1e6, 0, 'f', 2)
+     .arg(info.nodesPerSecond() / 1e6, 0, 'f', 2)
+     .arg(qRound(info.ttHitRate * 100))
+     .arg(qRound(info.firstMoveCutoffRate * 100))
+     .arg(pv.trimmed()));
+    engineInfoLabel->show();
+}
+
 /**
  * @brief Displays a dialog announcing the game winner with options to restart or return to menu.
  */
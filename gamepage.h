@@ -20,6 +20,7 @@
 #include "arrowbutton.h"
 #include "piece.h"         // For PieceColor enum
 #include "checkersboard.h" // For game logic
+#include "AIWorker.h"      // For SearchInfo
 
 /**
  * @class GamePage
@@ -72,11 +73,15 @@ public slots:
     // Displays the game-over dialog with winner message and options.
     void showGameOverDialog(PieceColor winner);
 
+    // Shows the AI's latest search report in the engine panel.
+    void updateEngineInfo(const SearchInfo &info);
+
 private:
     QPushButton *backButton, *exitButton, *undoButton; // Control buttons
     QLabel *redUndosLabel;                             // Red player's undo label
     QLabel *blackUndosLabel;                           // Black player's undo label
     QLabel *turnIndicatorLabel;                        // Displays current player's turn
+    QLabel *engineInfoLabel;                           // AI's depth, score and PV (PvAI, hidden until it searches)
 };
 
 #endif
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <QFontDatabase>
 #include <QDebug>
 #include "mainwindow.h"
+#include "Trace.h"
 // #include "checkersmenu.h"
 // #include "checkersmanager.h"
 
@@ -17,6 +18,10 @@ int main(int argc, char *argv[])
     // Initialize the Qt application
     QApplication app(argc, argv);
 
+    // CHECKERS_TRACE=trace.json records a Chrome trace, written when the app exits
+    if (Trace::startFromEnvironment())
+        qDebug() << "Tracing to" << qgetenv("CHECKERS_TRACE");
+
     // Load custom font (Russo One)
     QFontDatabase::addApplicationFont(":/Fonts/RussoOne-Regular.ttf");
 
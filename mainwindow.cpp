@@ -18,6 +18,7 @@
 #include "checkersmanager.h"
 #include "settingsdialog.h"
 #include "gamedescriptionpage.h"
+#include "Trace.h"
 
 
 /**
@@ -101,36 +102,42 @@ void MainWindow::initializeSoundEffects() {
 
 /// @brief Plays move sound if enabled.
 void MainWindow::playPieceMoveSound() {
+    TRACE_SCOPE("MainWindow::playPieceMoveSound");
     if (isSoundEffectsEnabled && soundEffects.contains("piece_move"))
         soundEffects["piece_move"]->play();
 }
 
 /// @brief Plays capture sound if enabled.
 void MainWindow::playPieceCaptureSound() {
+    TRACE_SCOPE("MainWindow::playPieceCaptureSound");
     if (isSoundEffectsEnabled && soundEffects.contains("piece_capture"))
         soundEffects["piece_capture"]->play();
 }
 
 /// @brief Plays king promotion sound if enabled.
 void MainWindow::playKingPromotionSound() {
+    TRACE_SCOPE("MainWindow::playKingPromotionSound");
     if (isSoundEffectsEnabled && soundEffects.contains("king_promotion"))
         soundEffects["king_promotion"]->play();
 }
 
 /// @brief Plays turn change sound if enabled.
 void MainWindow::playTurnChangeSound() {
+    TRACE_SCOPE("MainWindow::playTurnChangeSound");
     if (isSoundEffectsEnabled && soundEffects.contains("turn_change"))
         soundEffects["turn_change"]->play();
 }
 
 /// @brief Plays game over sound if enabled.
 void MainWindow::playGameEndSound() {
+    TRACE_SCOPE("MainWindow::playGameEndSound");
     if (isSoundEffectsEnabled && soundEffects.contains("game_end"))
         soundEffects["game_end"]->play();
 }
 
 /// @brief Plays UI selection sound (e.g., button clicks).
 void MainWindow::playSelectSound() {
+    TRACE_SCOPE("MainWindow::playSelectSound");
     if (isSoundEffectsEnabled && soundEffects.contains("select"))
         soundEffects["select"]->play();
 }
@@ -153,6 +160,8 @@ void MainWindow::registerGames() {
 void MainWindow::showCheckersMenu() {
     currentGameKey = "Checkers";
     currentMenu = gameRegistry[currentGameKey].createMenu(this);
+    if (gameManager)
+        gameManager->deleteLater();
     gameManager = gameRegistry[currentGameKey].createManager(this);
 
     auto *menu = qobject_cast<CheckersMenu *>(currentMenu);
@@ -174,6 +183,10 @@ void MainWindow::showCheckersMenu() {
 void MainWindow::onStartGame(int numPlayers, const QString &difficulty, bool showHints, bool soundEnabled, bool aiEnabled)
 {
     currentGameWidget = gameRegistry[currentGameKey].createBoard();
+
+    // The previous manager owns a search thread and an AI; its destructor stops both
+    if (gameManager)
+        gameManager->deleteLater();
     gameManager = gameRegistry[currentGameKey].createManager(this);
 
     activeGamePage = new GamePage(currentGameWidget, gameRegistry[currentGameKey].title);
@@ -194,8 +207,11 @@ void MainWindow::onStartGame(int numPlayers, const QString &difficulty, bool sho
 
         // Connect core gameplay signals
         connect(activeGamePage, &GamePage::requestUndo, manager, &CheckersManager::undoMove);
+        connect(activeGamePage, &GamePage::backToMenu, manager, &CheckersManager::cancelAIMove);
+        connect(activeGamePage, &GamePage::playAgainRequested, manager, &CheckersManager::cancelAIMove);
         connect(manager, &CheckersManager::undoCountsUpdated, activeGamePage, &GamePage::updateUndoLabels);
         connect(manager, &CheckersManager::userUndoCountUpdated, activeGamePage, &GamePage::updateUserUndoLabel);
+        connect(manager, &CheckersManager::searchInfoUpdated, activeGamePage, &GamePage::updateEngineInfo);
         connect(board, &CheckersBoard::moveCompleted, this, &MainWindow::playPieceMoveSound);
         connect(board, &CheckersBoard::pieceCaptured, this, &MainWindow::playPieceCaptureSound);
         connect(board, &CheckersBoard::piecePromoted, this, &MainWindow::playKingPromotionSound);
@@ -0,0 +1,374 @@
+/**
+ * @file bench.cpp
+ * @brief Times the search on a fixed set of positions, to track its speed from one commit to the next.
+ *
+ * Usage: bench [--depth D] [--time MS] [--threads T] [--scaling N] [--hash MB] [--nnue FILE] [--json FILE]
+ *
+ * Every position of the suite is searched twice from an empty hash: once to
+ * a fixed depth (default 12) and once for a fixed time per move (default
+ * 200 ms). The fixed-depth pass reports the nodes, the time to reach the
+ * depth, the nodes per second and the effective branching factor (the d-th
+ * root of the nodes searched to depth d); the fixed-time pass reports the
+ * depth reached and the nodes per second.
+ *
+ * The signature is a hash of every fixed-depth result (nodes, move, score).
+ * With one thread it only changes when the search itself does, so a commit
+ * meant to be a pure speed-up must keep it. --json also writes every figure
+ * to a file ("-" for stdout) for comparing runs.
+ *
+ * --scaling N runs the suite at 1, 2, 4, ... threads up to N and reports
+ * each count's speedup over one thread: the time-to-depth ratio, and for the
+ * fixed-time pass the depth gained, also expressed as the time one thread
+ * would need for it (the one-thread branching factor to the power of the
+ * gain).
+ *
+ * The positions come from engine games and cover the opening, middlegame
+ * and endgame, with either side to move.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "MiniMaxAlgo.h"
+#include "Pdn.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* const SUITE[] = {
+    "B:W18,19,22,24,25,26,29,30,31,32:B1,2,3,4,8,9,10,11,12,13",
+    "B:WK3,22,24,25,29,31,32:B2,4,11,12,13,14,23",
+    "B:WK3,K5,22,25:B2,4,13,16,K19",
+    "B:W18,19,20,21,23,24,29,30,31,32:B1,2,4,7,9,10,11,12,13,16",
+    "B:WK2,19,21,22,24,25:B4,5,9,13,23",
+    "B:WK3,K9,15,21,25:B4,K6,13,26",
+    "B:W17,20,22,23,25,26,28,29,30,31,32:B1,2,3,4,5,6,7,8,11,12,13",
+    "W:W19,20,21,23,26,29,32:B2,3,4,10,11,12,14",
+    "B:W6,16,17,19,21:B4,8,12,14,K31",
+    "B:W11,17,21,22,23,24,26,29,30,31,32:B1,2,3,4,7,8,9,10,12,13",
+    "B:W17,19,20,21,22,23,29,30:B1,2,10,11,12,13,14,16",
+    "B:WK1,K6,20:BK10,11,12,18,19,K31",
+    "B:W17,19,20,21,22,23,25,26,29,31:B1,2,3,4,6,10,11,12,13,14",
+    "B:W10,18,19,20,29:B1,2,4,11,12,K26",
+    "B:WK6,20,21:B12,13,14,18,K26",
+    "B:W17,19,22,23,24,25,26,28,29,30,31,32:B1,2,3,4,6,7,8,9,10,12,13,15",
+    "W:W19,20,21,24,28,29,31:B1,2,3,8,10,12,13,27",
+    "B:W10,20,24,26:B2,12,17,18,K32",
+    "B:W7,17,18,22,25,26,28,29,30,31:B1,2,3,4,5,6,8,12,13",
+    "B:W14,23,28,29,31:B4,5,8,16",
+    "B:WK3,11,14,15:B5,K23",
+    "W:W17,19,25,29,30,31,32:B1,2,3,4,5,10,12,18,27",
+    "B:W19,22,23,25:B8,12,14,16",
+    "B:WK1,K2,K8:BK18,K32",
+    "B:W6,17,24,25,26,27,28,29,30,31,32:B1,2,3,4,5,7,8,11,13,16",
+    "W:W24,29,30,31,32:B1,4,10,12,14",
+    "B:WK7,17,31,32:B1,16,23,K25",
+    "W:W17,18,22,24,26,27,28,29,30,31,32:B1,2,4,5,8,9,10,11,13,15,19",
+    "W:W19,23,27,29,30,31:B4,12,13,14,16,21",
+    "B:WK1,6,15,30:B12,21,22,K23",
+    "B:W17,19,21,23,24,25,30,31,32:B1,2,3,4,8,10,12,14,16",
+    "B:WK1,10,20,21,23,25,28,31:B2,11,12,13,14,16",
+    "B:WK1,K7,K14,17,20:B11,16,K31",
+    "B:W17,18,23,24,25,27,28,29,30,31,32:B1,2,3,4,6,7,8,9,10,11,12",
+    "B:W18,19,21,22,23,24,28,32:B1,2,4,7,9,11,12,14",
+    "B:WK2,19,20,21,23:B4,11,12,25",
+    "B:W17,20,21,22,26,29,30,31,32:B1,2,3,4,5,9,10,12,13",
+    "B:W15,17,21,22,23,24,29,31:B1,7,9,10,12,13,14,16",
+    "B:WK9,21,25,31:B13,K15,23",
+    "B:W14,17,19,21,23,28,29,30,32:B2,3,4,5,6,7,10,11,12",
+};
+
+/// @brief Command-line options.
+struct Options {
+    int depth = 12;
+    int timeMillis = 200;
+    int threads = 1;
+    int scaling = 0;  ///< Highest thread count of a scaling run, 0 for a single run
+    int hashMB = 16;
+    std::string network;
+    std::string json;
+};
+
+/// @brief One search of one position.
+struct Result {
+    std::string fen;
+    std::string move;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    double millis = 0;
+
+    double nps() const { return millis > 0 ? nodes * 1000.0 / millis : 0.0; }
+};
+
+/// @brief Totals of one pass over the suite.
+struct Pass {
+    std::vector<Result> results;
+    uint64_t nodes = 0;
+    double millis = 0;
+
+    double nps() const { return millis > 0 ? nodes * 1000.0 / millis : 0.0; }
+
+    /// @brief Geometric mean of the per-position branching factors.
+    double branchingFactor() const {
+        double logSum = 0;
+        int count = 0;
+        for (const Result& result : results) {
+            if (result.depth > 0 && result.nodes > 0) {
+                logSum += std::log(static_cast<double>(result.nodes)) / result.depth;
+                count++;
+            }
+        }
+        return count ? std::exp(logSum / count) : 0.0;
+    }
+
+    /// @brief Average depth reached.
+    double averageDepth() const {
+        double sum = 0;
+        for (const Result& result : results)
+            sum += result.depth;
+        return results.empty() ? 0.0 : sum / results.size();
+    }
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--depth" && hasValue) {
+            options.depth = std::min(std::max(1, std::atoi(argv[++i])), static_cast<int>(MiniMaxAlgo::MAX_SEARCH_DEPTH));
+        } else if (arg == "--time" && hasValue) {
+            options.timeMillis = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--scaling" && hasValue) {
+            options.scaling = std::min(std::max(1, std::atoi(argv[++i])), static_cast<int>(MiniMaxAlgo::MAX_THREADS));
+        } else if (arg == "--hash" && hasValue) {
+            options.hashMB = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--nnue" && hasValue) {
+            options.network = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            options.json = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Searches every position of the suite from an empty hash.
+ * @param timeMillis Time per position, or -1 to search to the algorithm's depth.
+ * @param verbose Print a line per position.
+ */
+Pass runPass(MiniMaxAlgo& algo, int timeMillis, const char* title, bool verbose) {
+    std::printf("%s\n", title);
+    std::fflush(stdout);
+    Pass pass;
+    int index = 0;
+    for (const char* fen : SUITE) {
+        Position pos;
+        parsePdnFen(fen, pos);
+        algo.clearHash();
+        Move move = algo.getBestTimedMove(pos, timeMillis);
+        const SearchStats& stats = algo.lastSearchStats();
+
+        Result result;
+        result.fen = fen;
+        result.move = move.isNull() ? "none" : pdnMoveText(move);
+        result.score = stats.score;
+        result.depth = stats.depth;
+        result.nodes = stats.nodes + stats.qnodes;
+        result.millis = stats.elapsedMicros / 1000.0;
+        pass.nodes += result.nodes;
+        pass.millis += result.millis;
+
+        ++index;
+        if (verbose) {
+            std::printf("  %2d  depth %2d  %-10s %5d  nodes %10llu  %8.1f ms  %6.2f Mnps\n", index, result.depth,
+                        result.move.c_str(), result.score, static_cast<unsigned long long>(result.nodes),
+                        result.millis, result.nps() / 1e6);
+            std::fflush(stdout);
+        }
+        pass.results.push_back(result);
+    }
+    return pass;
+}
+
+/// @brief FNV-1a hash of the fixed-depth results.
+uint64_t signature(const Pass& pass) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (8 * i)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    };
+    for (const Result& result : pass.results) {
+        mix(result.nodes);
+        mix(static_cast<uint64_t>(static_cast<int64_t>(result.score)));
+        for (char c : result.move)
+            mix(static_cast<unsigned char>(c));
+    }
+    return hash;
+}
+
+std::string passJson(const Pass& pass) {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "{\"nodes\": %llu, \"ms\": %.1f, \"nps\": %.0f, \"average_depth\": %.2f, \"ebf\": %.3f, \"positions\": [",
+                  static_cast<unsigned long long>(pass.nodes), pass.millis, pass.nps(), pass.averageDepth(),
+                  pass.branchingFactor());
+    std::string text = buffer;
+    for (size_t i = 0; i < pass.results.size(); ++i) {
+        const Result& result = pass.results[i];
+        std::snprintf(buffer, sizeof(buffer),
+                      "%s\n      {\"fen\": \"%s\", \"move\": \"%s\", \"score\": %d, \"depth\": %d, \"nodes\": %llu, \"ms\": %.1f}",
+                      i ? "," : "", result.fen.c_str(), result.move.c_str(), result.score, result.depth,
+                      static_cast<unsigned long long>(result.nodes), result.millis);
+        text += buffer;
+    }
+    return text + "\n    ]}";
+}
+
+/// @brief Both passes of the suite at one thread count.
+struct Run {
+    int threads = 1;
+    Pass depthPass;
+    Pass timePass;
+};
+
+/// @brief Runs the fixed-depth and the fixed-time pass with the given thread count.
+bool runSuite(const Options& options, int threads, bool verbose, Run& run) {
+    MiniMaxAlgo fixedDepth(options.depth, options.hashMB);
+    MiniMaxAlgo fixedTime(MiniMaxAlgo::MAX_SEARCH_DEPTH, options.hashMB);
+    for (MiniMaxAlgo* algo : { &fixedDepth, &fixedTime }) {
+        algo->setThreads(threads);
+        if (!options.network.empty() && !(algo->loadNetwork(options.network) && algo->setEvaluator(Evaluator::Network))) {
+            std::fprintf(stderr, "bench: cannot load %s\n", options.network.c_str());
+            return false;
+        }
+    }
+
+    std::string suffix = (options.scaling > 0)
+        ? ", " + std::to_string(threads) + (threads == 1 ? " thread" : " threads") : "";
+    run.threads = threads;
+    std::string title = "fixed depth " + std::to_string(options.depth) + suffix;
+    run.depthPass = runPass(fixedDepth, -1, title.c_str(), verbose);
+    title = "fixed time " + std::to_string(options.timeMillis) + " ms" + suffix;
+    run.timePass = runPass(fixedTime, options.timeMillis, title.c_str(), verbose);
+    return true;
+}
+
+bool writeJson(const std::string& path, const std::string& text) {
+    FILE* out = (path == "-") ? stdout : std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "bench: cannot write %s\n", path.c_str());
+        return false;
+    }
+    std::fputs(text.c_str(), out);
+    if (out != stdout)
+        std::fclose(out);
+    return true;
+}
+
+/// @brief Runs the suite at 1, 2, 4, ... threads and prints each count's speedup over one thread.
+int runScaling(const Options& options, const char* evaluator) {
+    std::vector<int> counts;
+    for (int threads = 1; threads < options.scaling; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(options.scaling);
+
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 0 && static_cast<unsigned>(options.scaling) > cores)
+        std::fprintf(stderr, "bench: only %u hardware threads; higher counts cannot speed up\n", cores);
+
+    std::vector<Run> runs;
+    for (int threads : counts) {
+        Run run;
+        if (!runSuite(options, threads, false, run))
+            return 1;
+        runs.push_back(run);
+    }
+
+    const Run& base = runs.front();
+    double baseBranching = base.depthPass.branchingFactor();
+    std::printf("\n%zu positions, depth %d, %d ms, %s evaluation, %u hardware threads\n",
+                base.depthPass.results.size(), options.depth, options.timeMillis, evaluator, cores);
+    std::printf("threads  time to depth  speedup      Mnps  average depth  depth gain  time-equivalent speedup\n");
+    std::string rows;
+    for (const Run& run : runs) {
+        double depthSpeedup = (run.depthPass.millis > 0) ? base.depthPass.millis / run.depthPass.millis : 0.0;
+        double depthGain = run.timePass.averageDepth() - base.timePass.averageDepth();
+        double timeSpeedup = std::pow(baseBranching, depthGain);
+        std::printf("%7d  %10.1f ms  %6.2fx  %8.2f  %13.2f  %+10.2f  %22.2fx\n", run.threads, run.depthPass.millis,
+                    depthSpeedup, run.depthPass.nps() / 1e6, run.timePass.averageDepth(), depthGain, timeSpeedup);
+
+        char buffer[256];
+        std::snprintf(buffer, sizeof(buffer),
+                      "%s\n    {\"threads\": %d, \"depth_ms\": %.1f, \"depth_speedup\": %.3f, \"nps\": %.0f, "
+                      "\"average_depth\": %.2f, \"depth_gain\": %.2f, \"time_speedup\": %.3f}",
+                      rows.empty() ? "" : ",", run.threads, run.depthPass.millis, depthSpeedup, run.depthPass.nps(),
+                      run.timePass.averageDepth(), depthGain, timeSpeedup);
+        rows += buffer;
+    }
+
+    if (!options.json.empty()) {
+        char header[256];
+        std::snprintf(header, sizeof(header),
+                      "{\n  \"depth\": %d,\n  \"time_ms\": %d,\n  \"evaluation\": \"%s\",\n  \"scaling\": [",
+                      options.depth, options.timeMillis, evaluator);
+        if (!writeJson(options.json, std::string(header) + rows + "\n  ]\n}\n"))
+            return 1;
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: bench [--depth D] [--time MS] [--threads T] [--scaling N] [--hash MB] [--nnue FILE] [--json FILE]\n");
+        return 1;
+    }
+
+    const char* evaluator = options.network.empty() ? "classic" : "network";
+    if (options.scaling > 0)
+        return runScaling(options, evaluator);
+
+    Run run;
+    if (!runSuite(options, options.threads, true, run))
+        return 1;
+    const Pass& depthPass = run.depthPass;
+    const Pass& timePass = run.timePass;
+    uint64_t sign = signature(depthPass);
+
+    std::printf("\n%zu positions, %d thread%s, %s evaluation\n", depthPass.results.size(), options.threads,
+                options.threads == 1 ? "" : "s", evaluator);
+    std::printf("depth %-3d  nodes %12llu  time to depth %9.1f ms  %6.2f Mnps  ebf %.3f\n", options.depth,
+                static_cast<unsigned long long>(depthPass.nodes), depthPass.millis, depthPass.nps() / 1e6,
+                depthPass.branchingFactor());
+    std::printf("%4d ms    nodes %12llu  average depth %9.2f     %6.2f Mnps\n", options.timeMillis,
+                static_cast<unsigned long long>(timePass.nodes), timePass.averageDepth(), timePass.nps() / 1e6);
+    std::printf("signature  %016llx\n", static_cast<unsigned long long>(sign));
+
+    if (!options.json.empty()) {
+        char header[256];
+        std::snprintf(header, sizeof(header),
+                      "{\n  \"depth\": %d,\n  \"time_ms\": %d,\n  \"threads\": %d,\n  \"evaluation\": \"%s\",\n"
+                      "  \"signature\": \"%016llx\",\n",
+                      options.depth, options.timeMillis, options.threads, evaluator,
+                      static_cast<unsigned long long>(sign));
+        std::string text = std::string(header) + "  \"fixed_depth\": " + passJson(depthPass) + ",\n"
+                         + "  \"fixed_time\": " + passJson(timePass) + "\n}\n";
+        if (!writeJson(options.json, text))
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+# Search benchmark: qmake tools/bench/bench.pro && make
+
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+TEMPLATE = app
+TARGET = bench
+
+LIBS += -pthread
+QMAKE_CXXFLAGS += -pthread
+
+include(../../engine.pri)
+
+SOURCES += \
+    bench.cpp
@@ -0,0 +1,150 @@
+/**
+ * @file bookgen.cpp
+ * @brief Builds an opening book from game records in PDN.
+ *
+ * Usage: bookgen [--plies N] [--min-games G] [--out FILE] games.pdn...
+ *
+ * Every game is replayed from the standard starting position. For each of
+ * its first N plies the move played is credited with the result for the side
+ * that played it: 2 for a win, 1 for a draw, 0 for a loss. A move becomes a
+ * book entry once it was played in at least G games, weighted by its credit,
+ * so moves that won more often are chosen more often and moves that only
+ * ever lost are left out.
+ *
+ * Games with a [FEN] tag or an unknown result are skipped, and a game with an
+ * illegal move is used up to that move (see Pdn.h for the notation).
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "OpeningBook.h"
+#include "Pdn.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/// @brief Credit and game count of one (position, move) pair.
+struct MoveStats {
+    uint32_t games = 0;   ///< Games in which the move was played here
+    uint32_t credit = 0;  ///< 2 per win and 1 per draw for the side that played it
+};
+
+using MoveKey = std::tuple<uint64_t, uint32_t, uint8_t, uint8_t>;  // key, captured, from, to
+
+/// @brief Command-line options.
+struct Options {
+    int plies = 12;
+    int minGames = 2;
+    std::string out = "book.ckb";
+    std::vector<std::string> inputs;
+};
+
+/**
+ * @class BookBuilder
+ * @brief Collects the statistics of the games' opening moves.
+ */
+class BookBuilder {
+public:
+    explicit BookBuilder(int plies) : maxPlies(plies) {}
+
+    /// @brief Reads every game of a PDN file.
+    bool addFile(const std::string& path) {
+        return readPdnFile(path, [this](const PdnGame& game) { addGame(game); });
+    }
+
+    /// @brief Turns the statistics into book entries.
+    std::vector<BookEntry> entries(int minGames) const {
+        std::vector<BookEntry> result;
+        for (const auto& item : stats) {
+            if (item.second.games < static_cast<uint32_t>(minGames) || item.second.credit == 0)
+                continue;
+            BookEntry entry;
+            std::tie(entry.key, entry.captured, entry.from, entry.to) = item.first;
+            entry.weight = static_cast<uint16_t>(std::min<uint32_t>(item.second.credit, 65535));
+            result.push_back(entry);
+        }
+        return result;
+    }
+
+    int gamesUsed() const { return used; }
+    int gamesSkipped() const { return skipped; }
+
+private:
+    int maxPlies;
+    std::map<MoveKey, MoveStats> stats;
+    int used = 0;
+    int skipped = 0;
+
+    /// @brief Credits the opening moves of one game with its result.
+    void addGame(const PdnGame& game) {
+        if (game.blackCredit < 0 || game.moves.empty()) {
+            if (!game.moves.empty() || game.setUp || !game.complete)
+                skipped++;
+            return;
+        }
+
+        Position pos = Position::initial();
+        int plies = std::min(maxPlies, static_cast<int>(game.moves.size()));
+        for (int ply = 0; ply < plies; ++ply) {
+            const Move& move = game.moves[ply];
+            MoveStats& entry = stats[MoveKey(pos.hash(), move.captured, move.from, move.to)];
+            entry.games++;
+            entry.credit += (pos.sideToMove == Side::Black) ? game.blackCredit : 2 - game.blackCredit;
+            pos.applyMove(move);
+        }
+        used++;
+    }
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--plies" && hasValue) {
+            options.plies = std::atoi(argv[++i]);
+        } else if (arg == "--min-games" && hasValue) {
+            options.minGames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    return options.plies > 0 && !options.inputs.empty();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: bookgen [--plies N] [--min-games G] [--out FILE] games.pdn...\n");
+        return 1;
+    }
+
+    BookBuilder builder(options.plies);
+    for (const std::string& path : options.inputs) {
+        if (!builder.addFile(path)) {
+            std::fprintf(stderr, "bookgen: cannot read %s\n", path.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<BookEntry> entries = builder.entries(options.minGames);
+    if (!OpeningBook::write(options.out, entries)) {
+        std::fprintf(stderr, "bookgen: cannot write %s\n", options.out.c_str());
+        return 1;
+    }
+
+    std::printf("%d games used, %d skipped, %zu book moves written to %s\n",
+                builder.gamesUsed(), builder.gamesSkipped(), entries.size(), options.out.c_str());
+    return 0;
+}
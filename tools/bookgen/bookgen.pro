@@ -0,0 +1,15 @@
+# Opening book builder: qmake tools/bookgen/bookgen.pro && make
+
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+TEMPLATE = app
+TARGET = bookgen
+
+LIBS += -pthread
+QMAKE_CXXFLAGS += -pthread
+
+include(../../engine.pri)
+
+SOURCES += \
+    bookgen.cpp
@@ -0,0 +1,593 @@
+/**
+ * @file match.cpp
+ * @brief Plays engine-vs-engine matches without the GUI and reports the Elo difference.
+ *
+ * Usage: match --engine-a SPEC --engine-b SPEC [--games N] [--concurrency C]
+ *              [--openings FILE] [--max-plies P] [--sprt ELO0 ELO1] [--pdn FILE]
+ *        match --serve SPEC
+ *
+ * An engine SPEC is a comma-separated list of key=value settings:
+ *   name=TEXT   name in the report and the game records
+ *   time=MS     thinking time per move (default 100; 0 for depth only)
+ *   depth=D     depth cap (default unlimited)
+ *   hash=MB     transposition table size (default 16)
+ *   tb=DIR      endgame tablebases written by tbgen
+ *   nnue=FILE   evaluate with this network instead of the hand-written evaluation
+ *   cmd=PATH    run another build of this tool as the engine ("PATH --serve SPEC",
+ *               with the other settings passed on), so two versions of the
+ *               search can be compared. POSIX only.
+ *
+ * Every opening is played twice, once with each engine on each side, so an
+ * unbalanced opening cannot favour either. Without --openings, the openings
+ * are every three-ply start whose shallow search score is close to even (the
+ * "three-move ballot"); a PDN file gives its own, each game's moves being one
+ * opening. Games run in parallel, one per thread, each engine searching on a
+ * single thread. A game is drawn by threefold repetition or after P plies.
+ *
+ * After every game the running score is turned into an Elo difference with a
+ * 95% error bar. With --sprt the match stops as soon as the sequential
+ * probability ratio test accepts "A is ELO0 better" or "A is ELO1 better"
+ * (alpha = beta = 0.05). Every game is written to the PDN file.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "MiniMaxAlgo.h"
+#include "Pdn.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int BALLOT_PLIES = 3;    // Length of the generated openings
+const int BALLOT_DEPTH = 6;    // Search depth that judges them
+const int BALLOT_MARGIN = 3;   // Largest score still counted as balanced
+const double SPRT_ALPHA = 0.05;
+const double SPRT_BETA = 0.05;
+
+/// @brief Settings of one engine, parsed from a SPEC.
+struct EngineSpec {
+    std::string name;
+    int timeMillis = 100;
+    int depth = MiniMaxAlgo::MAX_SEARCH_DEPTH;
+    int hashMB = 16;
+    std::string tablebases;
+    std::string network;
+    std::string command;
+    std::string forwarded;  ///< Every setting but cmd, for the served engine
+};
+
+/// @brief Command-line options.
+struct Options {
+    EngineSpec engines[2];
+    int games = 0;  // 0: two per opening
+    int concurrency = 1;
+    std::string openings;
+    int maxPlies = 300;
+    bool sprt = false;
+    double elo0 = 0, elo1 = 5;
+    std::string pdn = "match.pdn";
+};
+
+bool parseSpec(const std::string& text, EngineSpec& spec) {
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos)
+            return false;
+        std::string key = item.substr(0, equals);
+        std::string value = item.substr(equals + 1);
+
+        if (key == "name") spec.name = value;
+        else if (key == "time") spec.timeMillis = std::max(0, std::atoi(value.c_str()));
+        else if (key == "depth") spec.depth = std::max(1, std::atoi(value.c_str()));
+        else if (key == "hash") spec.hashMB = std::max(1, std::atoi(value.c_str()));
+        else if (key == "tb") spec.tablebases = value;
+        else if (key == "nnue") spec.network = value;
+        else if (key == "cmd") spec.command = value;
+        else return false;
+
+        if (key != "cmd")
+            spec.forwarded += (spec.forwarded.empty() ? "" : ",") + item;
+    }
+    return true;
+}
+
+/**
+ * @class Engine
+ * @brief A player the match can ask for moves.
+ */
+class Engine {
+public:
+    virtual ~Engine() = default;
+
+    /// @brief Forgets the previous game.
+    virtual void newGame() = 0;
+
+    /**
+     * @brief Chooses a move.
+     * @return false if the engine failed (it then forfeits the game).
+     */
+    virtual bool bestMove(const Position& pos, Move& move) = 0;
+};
+
+/**
+ * @class LocalEngine
+ * @brief The search of this build, on one thread.
+ */
+class LocalEngine : public Engine {
+public:
+    explicit LocalEngine(const EngineSpec& spec)
+        : algo(spec.depth, spec.hashMB),
+          timeMillis(spec.timeMillis > 0 ? spec.timeMillis : -1) {
+        if (!spec.tablebases.empty())
+            algo.loadTablebases(spec.tablebases);
+        if (!spec.network.empty() && algo.loadNetwork(spec.network))
+            algo.setEvaluator(Evaluator::Network);
+    }
+
+    /// @brief Returns false if the spec asked for a network that could not be loaded.
+    bool ready(const EngineSpec& spec) const {
+        return spec.network.empty() || algo.currentEvaluator() == Evaluator::Network;
+    }
+
+    void newGame() override {
+        algo.clearHash();
+    }
+
+    bool bestMove(const Position& pos, Move& move) override {
+        move = algo.getBestTimedMove(pos, timeMillis);
+        return !move.isNull();
+    }
+
+private:
+    MiniMaxAlgo algo;
+    int timeMillis;
+};
+
+#ifndef _WIN32
+
+/**
+ * @class RemoteEngine
+ * @brief Another build of this tool running "--serve", talked to over pipes.
+ *
+ * Protocol, one line each way: "isready" -> "readyok"; "new"; "go RED BLACK
+ * KINGS SIDE" -> "move FROM TO CAPTURED" or "move none"; "quit".
+ */
+class RemoteEngine : public Engine {
+public:
+    explicit RemoteEngine(const EngineSpec& spec) {
+        int toChild[2], fromChild[2];
+        if (pipe(toChild) != 0 || pipe(fromChild) != 0)
+            return;
+
+        pid = fork();
+        if (pid == 0) {
+            dup2(toChild[0], STDIN_FILENO);
+            dup2(fromChild[1], STDOUT_FILENO);
+            close(toChild[0]); close(toChild[1]);
+            close(fromChild[0]); close(fromChild[1]);
+            execl(spec.command.c_str(), spec.command.c_str(), "--serve", spec.forwarded.c_str(),
+                  static_cast<char*>(nullptr));
+            _exit(127);
+        }
+
+        close(toChild[0]);
+        close(fromChild[1]);
+        input = fdopen(toChild[1], "w");
+        output = fdopen(fromChild[0], "r");
+    }
+
+    ~RemoteEngine() override {
+        if (input) {
+            std::fputs("quit\n", input);
+            std::fclose(input);
+        }
+        if (output)
+            std::fclose(output);
+        if (pid > 0)
+            waitpid(pid, nullptr, 0);
+    }
+
+    /// @brief Returns true once the engine has answered "isready".
+    bool ready() {
+        return send("isready") && receive() == "readyok";
+    }
+
+    void newGame() override {
+        send("new");
+    }
+
+    bool bestMove(const Position& pos, Move& move) override {
+        std::string command = "go " + std::to_string(pos.red) + " " + std::to_string(pos.black) + " "
+                            + std::to_string(pos.kings) + " " + std::to_string(static_cast<int>(pos.sideToMove));
+        if (!send(command))
+            return false;
+
+        std::stringstream reply(receive());
+        std::string word;
+        unsigned from, to;
+        uint32_t captured;
+        if (!(reply >> word >> from >> to >> captured) || word != "move")
+            return false;
+
+        // The reply only names the move; find it among the legal ones
+        MoveList moves;
+        generateMoves(pos, moves);
+        for (const Move& legal : moves) {
+            if (legal.from == from && legal.to == to && legal.captured == captured) {
+                move = legal;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    pid_t pid = -1;
+    FILE* input = nullptr;   ///< Engine's stdin
+    FILE* output = nullptr;  ///< Engine's stdout
+
+    bool send(const std::string& line) {
+        return input && std::fprintf(input, "%s\n", line.c_str()) > 0 && std::fflush(input) == 0;
+    }
+
+    std::string receive() {
+        char buffer[256];
+        if (!output || !std::fgets(buffer, sizeof(buffer), output))
+            return std::string();
+        std::string line = buffer;
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.pop_back();
+        return line;
+    }
+};
+
+#endif
+
+/// @brief Creates an engine from its spec, or returns null if it cannot start.
+std::unique_ptr<Engine> createEngine(const EngineSpec& spec) {
+    if (!spec.command.empty()) {
+#ifndef _WIN32
+        RemoteEngine* engine = new RemoteEngine(spec);
+        if (engine->ready())
+            return std::unique_ptr<Engine>(engine);
+        delete engine;
+#endif
+        return nullptr;
+    }
+    LocalEngine* engine = new LocalEngine(spec);
+    if (engine->ready(spec))
+        return std::unique_ptr<Engine>(engine);
+    delete engine;
+    return nullptr;
+}
+
+/// @brief Answers the RemoteEngine protocol on stdin/stdout.
+int serve(const EngineSpec& spec) {
+    std::unique_ptr<Engine> engine = createEngine(spec);
+    if (!engine)
+        return 1;
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::stringstream in(line);
+        std::string command;
+        in >> command;
+        if (command == "isready") {
+            std::cout << "readyok" << std::endl;
+        } else if (command == "new") {
+            engine->newGame();
+        } else if (command == "go") {
+            Position pos;
+            int side = 0;
+            in >> pos.red >> pos.black >> pos.kings >> side;
+            pos.sideToMove = static_cast<Side>(side);
+            pos.key = pos.computeKey();
+            pos.psqt = pos.computePsqt();
+
+            Move move;
+            if (engine->bestMove(pos, move))
+                std::cout << "move " << int(move.from) << " " << int(move.to) << " " << move.captured << std::endl;
+            else
+                std::cout << "move none" << std::endl;
+        } else if (command == "quit") {
+            break;
+        }
+    }
+    return 0;
+}
+
+/// @brief Every distinct three-ply start that a shallow search scores as close to even.
+std::vector<std::vector<Move>> ballotOpenings() {
+    std::vector<std::vector<Move>> result;
+    std::unordered_set<uint64_t> seen;
+    MiniMaxAlgo judge(BALLOT_DEPTH, 4);
+
+    std::vector<Move> line;
+    std::function<void(const Position&)> extend = [&](const Position& pos) {
+        if (static_cast<int>(line.size()) == BALLOT_PLIES) {
+            if (!seen.insert(pos.hash()).second)
+                return;
+            Position copy = pos;
+            if (std::abs(judge.minimax(copy, BALLOT_DEPTH).first) <= BALLOT_MARGIN)
+                result.push_back(line);
+            return;
+        }
+        MoveList moves;
+        generateMoves(pos, moves);
+        for (const Move& move : moves) {
+            Position child = pos;
+            child.applyMove(move);
+            line.push_back(move);
+            extend(child);
+            line.pop_back();
+        }
+    };
+    extend(Position::initial());
+    return result;
+}
+
+/// @brief The move lists of every complete game in a PDN file.
+bool readOpenings(const std::string& path, std::vector<std::vector<Move>>& openings) {
+    return readPdnFile(path, [&](const PdnGame& game) {
+        if (!game.setUp && game.complete && !game.moves.empty())
+            openings.push_back(game.moves);
+    });
+}
+
+/**
+ * @brief Plays one game from an opening.
+ * @param players Engines by side: [0] plays Red, [1] plays Black.
+ * @param moves Receives every move, the opening's included.
+ * @return The credit for Black: 2 win, 1 draw, 0 loss.
+ */
+int playGame(Engine* players[2], const std::vector<Move>& opening, int maxPlies, std::vector<Move>& moves) {
+    Position pos = Position::initial();
+    for (const Move& move : opening) {
+        pos.applyMove(move);
+        moves.push_back(move);
+    }
+    players[0]->newGame();
+    players[1]->newGame();
+
+    std::unordered_map<uint64_t, int> seen;
+    seen[pos.hash()]++;
+    while (static_cast<int>(moves.size()) < maxPlies) {
+        // No legal move loses; so does an engine that fails to give one
+        MoveList legal;
+        generateMoves(pos, legal);
+        Move move;
+        if (legal.empty() || !players[static_cast<int>(pos.sideToMove)]->bestMove(pos, move))
+            return (pos.sideToMove == Side::Black) ? 0 : 2;
+
+        pos.applyMove(move);
+        moves.push_back(move);
+        if (++seen[pos.hash()] >= 3)
+            return 1;
+    }
+    return 1;
+}
+
+/// @brief Elo difference that gives an expected score.
+double eloFromScore(double score) {
+    score = std::min(std::max(score, 1e-6), 1 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+/// @brief Expected score of an Elo difference.
+double scoreFromElo(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+/**
+ * @struct MatchScore
+ * @brief Results so far from engine A's point of view.
+ */
+struct MatchScore {
+    int wins = 0, losses = 0, draws = 0;
+
+    int games() const { return wins + losses + draws; }
+    double score() const { return games() ? (wins + 0.5 * draws) / games() : 0.5; }
+
+    /// @brief Variance of one game's score.
+    double variance() const {
+        double s = score();
+        int n = games();
+        if (n == 0) return 0;
+        return (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / n;
+    }
+
+    /// @brief Elo difference and the half-width of its 95% interval.
+    void elo(double& difference, double& margin) const {
+        double s = score();
+        double error = games() ? 1.96 * std::sqrt(variance() / games()) : 0;
+        difference = eloFromScore(s);
+        margin = (eloFromScore(s + error) - eloFromScore(s - error)) / 2;
+    }
+
+    /// @brief Log-likelihood ratio of ELO1 against ELO0 (normal approximation).
+    double llr(double elo0, double elo1) const {
+        double var = variance();
+        if (var <= 0) return 0;
+        double s0 = scoreFromElo(elo0), s1 = scoreFromElo(elo1);
+        return games() * (s1 - s0) * (2 * score() - s0 - s1) / (2 * var);
+    }
+};
+
+bool parseOptions(int argc, char* argv[], Options& options, bool& serving) {
+    options.concurrency = std::max(1u, std::thread::hardware_concurrency());
+    options.engines[0].name = "A";
+    options.engines[1].name = "B";
+    bool haveA = false, haveB = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--serve" && hasValue) {
+            serving = true;
+            return parseSpec(argv[++i], options.engines[0]);
+        } else if (arg == "--engine-a" && hasValue) {
+            haveA = parseSpec(argv[++i], options.engines[0]);
+        } else if (arg == "--engine-b" && hasValue) {
+            haveB = parseSpec(argv[++i], options.engines[1]);
+        } else if (arg == "--games" && hasValue) {
+            options.games = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--concurrency" && hasValue) {
+            options.concurrency = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--openings" && hasValue) {
+            options.openings = argv[++i];
+        } else if (arg == "--max-plies" && hasValue) {
+            options.maxPlies = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--sprt" && i + 2 < argc) {
+            options.sprt = true;
+            options.elo0 = std::atof(argv[++i]);
+            options.elo1 = std::atof(argv[++i]);
+        } else if (arg == "--pdn" && hasValue) {
+            options.pdn = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return haveA && haveB && (!options.sprt || options.elo1 > options.elo0);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    bool serving = false;
+    if (!parseOptions(argc, argv, options, serving)) {
+        std::fprintf(stderr,
+                     "usage: match --engine-a SPEC --engine-b SPEC [--games N] [--concurrency C]\n"
+                     "             [--openings FILE] [--max-plies P] [--sprt ELO0 ELO1] [--pdn FILE]\n"
+                     "       match --serve SPEC\n"
+                     "SPEC: name=TEXT,time=MS,depth=D,hash=MB,tb=DIR,nnue=FILE,cmd=PATH\n");
+        return 1;
+    }
+#ifndef _WIN32
+    std::signal(SIGPIPE, SIG_IGN);  // A crashed remote engine must not take the match down
+#endif
+    if (serving)
+        return serve(options.engines[0]);
+
+    std::vector<std::vector<Move>> openings;
+    if (options.openings.empty()) {
+        openings = ballotOpenings();
+    } else if (!readOpenings(options.openings, openings)) {
+        std::fprintf(stderr, "match: cannot read %s\n", options.openings.c_str());
+        return 1;
+    }
+    if (openings.empty()) {
+        std::fprintf(stderr, "match: no openings\n");
+        return 1;
+    }
+    int totalGames = options.games ? options.games : 2 * static_cast<int>(openings.size());
+
+    std::ofstream records(options.pdn);
+    if (!records) {
+        std::fprintf(stderr, "match: cannot write %s\n", options.pdn.c_str());
+        return 1;
+    }
+    std::printf("%s vs %s: %d games from %zu openings on %d threads\n", options.engines[0].name.c_str(),
+                options.engines[1].name.c_str(), totalGames, openings.size(), options.concurrency);
+    std::fflush(stdout);
+
+    const double lowerBound = std::log(SPRT_BETA / (1 - SPRT_ALPHA));
+    const double upperBound = std::log((1 - SPRT_BETA) / SPRT_ALPHA);
+
+    std::atomic<int> nextGame{0};
+    std::atomic<bool> finished{false};
+    std::atomic<bool> failed{false};
+    std::mutex resultMutex;
+    MatchScore score;
+
+    auto worker = [&]() {
+        std::unique_ptr<Engine> engines[2] = { createEngine(options.engines[0]), createEngine(options.engines[1]) };
+        if (!engines[0] || !engines[1]) {
+            failed = true;
+            finished = true;
+            return;
+        }
+
+        while (!finished) {
+            int game = nextGame.fetch_add(1);
+            if (game >= totalGames)
+                return;
+
+            // Each opening twice: A takes Black (who moves first) in even games
+            const std::vector<Move>& opening = openings[(game / 2) % openings.size()];
+            bool aIsBlack = game % 2 == 0;
+            Engine* players[2];
+            players[static_cast<int>(Side::Black)] = engines[aIsBlack ? 0 : 1].get();
+            players[static_cast<int>(Side::Red)] = engines[aIsBlack ? 1 : 0].get();
+
+            std::vector<Move> moves;
+            int blackCredit = playGame(players, opening, options.maxPlies, moves);
+            int aCredit = aIsBlack ? blackCredit : 2 - blackCredit;
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (finished)
+                return;  // SPRT already decided; this game is not counted
+            if (aCredit == 2) score.wins++;
+            else if (aCredit == 0) score.losses++;
+            else score.draws++;
+
+            const EngineSpec& blackSpec = options.engines[aIsBlack ? 0 : 1];
+            const EngineSpec& redSpec = options.engines[aIsBlack ? 1 : 0];
+            records << pdnGameText({ { "Event", "match" }, { "Round", std::to_string(game + 1) },
+                                     { "Black", blackSpec.name }, { "White", redSpec.name } },
+                                   moves, blackCredit);
+
+            double elo, margin;
+            score.elo(elo, margin);
+            std::printf("game %d: %s +%d -%d =%d  Elo %+.1f +/- %.1f", score.games(),
+                        options.engines[0].name.c_str(), score.wins, score.losses, score.draws, elo, margin);
+            if (options.sprt) {
+                double llr = score.llr(options.elo0, options.elo1);
+                std::printf("  LLR %.2f (%.2f, %.2f)", llr, lowerBound, upperBound);
+                if (llr <= lowerBound || llr >= upperBound) {
+                    std::printf("\nSPRT: %s accepted", llr >= upperBound ? "H1 (ELO1)" : "H0 (ELO0)");
+                    finished = true;
+                }
+            }
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < options.concurrency; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread& t : workers)
+        t.join();
+
+    if (failed) {
+        std::fprintf(stderr, "match: an engine could not be started\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+# Engine-vs-engine match runner: qmake tools/match/match.pro && make
+
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+TEMPLATE = app
+TARGET = match
+
+LIBS += -pthread
+QMAKE_CXXFLAGS += -pthread
+
+include(../../engine.pri)
+
+SOURCES += \
+    match.cpp
@@ -0,0 +1,480 @@
+/**
+ * @file perft.cpp
+ * @brief Counts the positions the move generator reaches, to measure its speed and prove it correct.
+ *
+ * Usage: perft [--fen FEN] [--depth N] [--threads T] [--divide] [--verify]
+ *
+ * Without --fen, runs the built-in suite: the starting position and a few
+ * positions chosen for their capture trees (branching multi-jumps, men crowned
+ * partway through a capture, kings with several routes to the same square).
+ * Each is counted to its depth and compared with the known leaf count; with
+ * --depth every position is counted to that depth instead and only timed.
+ *
+ * Counting is bulk at the last ply (the size of the move list) and split over
+ * threads by the subtrees two plies down. --divide prints the count below each
+ * root move, the usual way to find where two generators differ.
+ *
+ * --verify walks the same tree with a second, deliberately naive generator
+ * written from the GUI's rules: a piece per cell, moved one hop at a time as
+ * CheckersBoard::handleMove() does, with isCaptureMove(), isCaptureAvailable()
+ * and the mandatory-capture check done square by square. At every node both
+ * must produce the same moves (start, every landing and resulting position),
+ * so any change to MoveGen is checked against the rules the player sees.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "MoveGen.h"
+#include "Pdn.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @struct SuitePosition
+ * @brief A position of the built-in suite with its known leaf count.
+ */
+struct SuitePosition {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+// A man crowned by a capture keeps jumping here, so from depth 9 the starting
+// position's counts differ from the published English draughts tables (3963680
+// and 18391564), where crowning ends the move. The crown positions mirror each other.
+const SuitePosition SUITE[] = {
+    { "start", "B:W21-32:B1-12", 10, 18391602ULL },
+    { "branches", "B:W6,7,14,15,22,23,24:B2,3,K11", 10, 7991425ULL },
+    { "king loop", "B:W10,11,18,19,26,27:BK15,1,2", 10, 7614810ULL },
+    { "crown black", "B:W11,12,19,20,25,26,27:B17,22", 10, 1755724ULL },
+    { "crown red", "W:W11,16:B6,7,8,13,14,21,22", 10, 1755724ULL },
+    { "kings", "B:W10,11,K14,K15,K22,K23:B1,K18,K19", 10, 11095519ULL },
+};
+
+/// @brief Leaf count below a position (bulk counted at the last ply).
+uint64_t perft(const Position& pos, int depth) {
+    MoveList moves;
+    generateMoves(pos, moves);
+    if (depth <= 1)
+        return depth == 1 ? moves.size() : 1;
+
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        Position child = pos;
+        child.applyMove(move);
+        nodes += perft(child, depth - 1);
+    }
+    return nodes;
+}
+
+// --- Reference rules, written the way CheckersBoard applies them ------------
+
+/**
+ * @struct Cell
+ * @brief One square of the reference board.
+ */
+struct Cell {
+    bool occupied = false;
+    Side side = Side::Red;
+    bool king = false;
+};
+
+/**
+ * @struct Board
+ * @brief The reference board: an 8x8 grid and the side to move.
+ */
+struct Board {
+    Cell cells[8][8];
+    Side turn = Side::Black;
+};
+
+/**
+ * @struct BoardMove
+ * @brief A complete move found by the reference rules.
+ */
+struct BoardMove {
+    int from;
+    std::vector<int> landings;  ///< Every square the piece stops on
+    Board after;
+};
+
+bool onBoard(int row, int col) {
+    return row >= 0 && row < 8 && col >= 0 && col < 8;
+}
+
+/// @brief Direction a man of a side moves in (rows).
+int forward(Side side) {
+    return side == Side::Red ? 1 : -1;
+}
+
+/// @brief CheckersBoard::isCaptureMove(): two squares diagonally over an opponent onto an empty square.
+bool isCaptureHop(const Board& board, int row, int col, int newRow, int newCol) {
+    const Cell& piece = board.cells[row][col];
+    if (!onBoard(newRow, newCol) || std::abs(newRow - row) != 2 || std::abs(newCol - col) != 2)
+        return false;
+    if (!piece.king && (newRow - row) / 2 != forward(piece.side))
+        return false;
+    if (board.cells[newRow][newCol].occupied)
+        return false;
+    const Cell& middle = board.cells[(row + newRow) / 2][(col + newCol) / 2];
+    return middle.occupied && middle.side != piece.side;
+}
+
+/// @brief CheckersBoard::isCaptureAvailable(): any of the four jumps.
+bool isCaptureAvailable(const Board& board, int row, int col) {
+    for (int dr = -2; dr <= 2; dr += 4)
+        for (int dc = -2; dc <= 2; dc += 4)
+            if (isCaptureHop(board, row, col, row + dr, col + dc))
+                return true;
+    return false;
+}
+
+/// @brief Crowns a man that has reached the far row (as handleMove() does after every hop).
+void promote(Cell& piece, int row) {
+    if (!piece.king && row == (piece.side == Side::Red ? 7 : 0))
+        piece.king = true;
+}
+
+/// @brief Follows every capture sequence; the piece must keep jumping while it can.
+void extendCaptures(const Board& board, int row, int col, int from, std::vector<int>& landings,
+                    std::vector<BoardMove>& moves) {
+    for (int dr = -2; dr <= 2; dr += 4) {
+        for (int dc = -2; dc <= 2; dc += 4) {
+            int newRow = row + dr, newCol = col + dc;
+            if (!isCaptureHop(board, row, col, newRow, newCol))
+                continue;
+
+            // The jumped piece leaves the board straight away
+            Board next = board;
+            next.cells[newRow][newCol] = next.cells[row][col];
+            next.cells[row][col] = Cell();
+            next.cells[(row + newRow) / 2][(col + newCol) / 2] = Cell();
+            promote(next.cells[newRow][newCol], newRow);
+
+            landings.push_back(squareOf(newRow, newCol));
+            if (isCaptureAvailable(next, newRow, newCol)) {
+                extendCaptures(next, newRow, newCol, from, landings, moves);
+            } else {
+                next.turn = opponent(next.turn);
+                moves.push_back({ from, landings, next });
+            }
+            landings.pop_back();
+        }
+    }
+}
+
+/// @brief Every legal move: captures if any piece can capture, otherwise single steps.
+std::vector<BoardMove> boardMoves(const Board& board) {
+    std::vector<BoardMove> moves;
+    std::vector<int> landings;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const Cell& piece = board.cells[row][col];
+            if (piece.occupied && piece.side == board.turn)
+                extendCaptures(board, row, col, squareOf(row, col), landings, moves);
+        }
+    }
+    if (!moves.empty())
+        return moves;
+
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const Cell& piece = board.cells[row][col];
+            if (!piece.occupied || piece.side != board.turn)
+                continue;
+            for (int dr = -1; dr <= 1; dr += 2) {
+                for (int dc = -1; dc <= 1; dc += 2) {
+                    int newRow = row + dr, newCol = col + dc;
+                    if (!onBoard(newRow, newCol) || board.cells[newRow][newCol].occupied)
+                        continue;
+                    if (!piece.king && dr != forward(piece.side))
+                        continue;
+
+                    Board next = board;
+                    next.cells[newRow][newCol] = piece;
+                    next.cells[row][col] = Cell();
+                    promote(next.cells[newRow][newCol], newRow);
+                    next.turn = opponent(next.turn);
+                    moves.push_back({ squareOf(row, col), { squareOf(newRow, newCol) }, next });
+                }
+            }
+        }
+    }
+    return moves;
+}
+
+Board toBoard(const Position& pos) {
+    Board board;
+    board.turn = pos.sideToMove;
+    for (int square = 0; square < NUM_SQUARES; ++square) {
+        if (!(pos.occupied() & bit(square)))
+            continue;
+        Cell& cell = board.cells[rowOf(square)][colOf(square)];
+        cell.occupied = true;
+        cell.side = (pos.red & bit(square)) ? Side::Red : Side::Black;
+        cell.king = (pos.kings & bit(square)) != 0;
+    }
+    return board;
+}
+
+Position toPosition(const Board& board) {
+    Position pos;
+    pos.sideToMove = board.turn;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const Cell& cell = board.cells[row][col];
+            if (cell.occupied)
+                pos.setPiece(squareOf(row, col), cell.side, cell.king);
+        }
+    }
+    return pos;
+}
+
+/// @brief A move and the position it leads to, in a form both generators can be compared by.
+struct MoveKey {
+    std::vector<int> squares;  ///< Start, then every landing
+    uint32_t red, black, kings;
+    Side sideToMove;
+
+    bool operator<(const MoveKey& other) const {
+        if (squares != other.squares) return squares < other.squares;
+        if (red != other.red) return red < other.red;
+        if (black != other.black) return black < other.black;
+        return kings < other.kings;
+    }
+    bool operator==(const MoveKey& other) const {
+        return squares == other.squares && red == other.red && black == other.black
+            && kings == other.kings && sideToMove == other.sideToMove;
+    }
+};
+
+std::string keyText(const MoveKey& key) {
+    bool capture = std::abs(rowOf(key.squares[1]) - rowOf(key.squares[0])) == 2;
+    std::string text = std::to_string(pdnFromSquare(key.squares[0]));
+    for (size_t i = 1; i < key.squares.size(); ++i)
+        text += (capture ? "x" : "-") + std::to_string(pdnFromSquare(key.squares[i]));
+    return text;
+}
+
+/**
+ * @brief Checks that both generators agree at every node of a subtree.
+ * @param nodes Receives the leaf count.
+ * @return false after printing the first position where they differ.
+ */
+bool verify(const Position& pos, int depth, uint64_t& nodes) {
+    MoveList moves;
+    generateMoves(pos, moves);
+
+    std::vector<MoveKey> fast;
+    for (const Move& move : moves) {
+        Position child = pos;
+        child.applyMove(move);
+        MoveKey key{ { move.from }, child.red, child.black, child.kings, child.sideToMove };
+        if (move.jumps == 0)
+            key.squares.push_back(move.to);
+        for (int i = 0; i < move.jumps; ++i)
+            key.squares.push_back(move.path[i]);
+        fast.push_back(key);
+    }
+
+    std::vector<MoveKey> reference;
+    for (const BoardMove& move : boardMoves(toBoard(pos))) {
+        Position child = toPosition(move.after);
+        MoveKey key{ { move.from }, child.red, child.black, child.kings, child.sideToMove };
+        key.squares.insert(key.squares.end(), move.landings.begin(), move.landings.end());
+        reference.push_back(key);
+    }
+
+    std::sort(fast.begin(), fast.end());
+    std::sort(reference.begin(), reference.end());
+    if (fast != reference) {
+        std::string text = "mismatch at " + pdnFenText(pos) + "\n  MoveGen:";
+        for (const MoveKey& key : fast)
+            text += " " + keyText(key);
+        text += "\n  rules:  ";
+        for (const MoveKey& key : reference)
+            text += " " + keyText(key);
+        std::printf("%s\n", text.c_str());
+        return false;
+    }
+
+    if (depth <= 1) {
+        nodes += (depth == 1) ? moves.size() : 1;
+        return true;
+    }
+    for (const Move& move : moves) {
+        Position child = pos;
+        child.applyMove(move);
+        if (!verify(child, depth - 1, nodes))
+            return false;
+    }
+    return true;
+}
+
+// --- Driver --------------------------------------------------------------
+
+/**
+ * @struct Subtree
+ * @brief One unit of work: a position a few plies down and the root move above it.
+ */
+struct Subtree {
+    Position pos;
+    int rootMove;
+};
+
+/// @brief Every position up to two plies down, each kept once per path that reaches it.
+std::vector<Subtree> splitTree(const Position& root, int plies) {
+    std::vector<Subtree> work;
+    MoveList moves;
+    generateMoves(root, moves);
+    for (int i = 0; i < moves.size(); ++i) {
+        Position child = root;
+        child.applyMove(moves[i]);
+        if (plies < 2) {
+            work.push_back({ child, i });
+            continue;
+        }
+        MoveList replies;
+        generateMoves(child, replies);
+        for (const Move& reply : replies) {
+            Position grandchild = child;
+            grandchild.applyMove(reply);
+            work.push_back({ grandchild, i });
+        }
+    }
+    return work;
+}
+
+/**
+ * @brief Counts (or verifies) a position on several threads.
+ * @param perMove Receives the leaf count below each root move.
+ * @return false if verification failed.
+ */
+bool count(const Position& root, int depth, int threads, bool check, std::vector<uint64_t>& perMove) {
+    MoveList moves;
+    generateMoves(root, moves);
+    perMove.assign(moves.size(), 0);
+    if (depth < 2) {
+        uint64_t nodes = 0;
+        bool ok = check ? verify(root, depth, nodes) : true;
+        if (depth == 1)
+            std::fill(perMove.begin(), perMove.end(), 1);
+        return ok;
+    }
+    int plies = (depth >= 3) ? 2 : 1;
+    if (check) {
+        // The plies above the split are checked here, the subtrees by the workers
+        uint64_t unused = 0;
+        if (!verify(root, plies, unused))
+            return false;
+    }
+
+    std::vector<Subtree> work = splitTree(root, plies);
+    std::vector<uint64_t> counts(work.size(), 0);
+    std::atomic<size_t> next{0};
+    std::atomic<bool> ok{true};
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < work.size() && ok; i = next++) {
+            if (!check) {
+                counts[i] = perft(work[i].pos, depth - plies);
+            } else if (!verify(work[i].pos, depth - plies, counts[i])) {
+                ok = false;
+            }
+        }
+    };
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; ++i)
+        helpers.emplace_back(worker);
+    worker();
+    for (std::thread& t : helpers)
+        t.join();
+
+    for (size_t i = 0; i < work.size(); ++i)
+        perMove[work[i].rootMove] += counts[i];
+    return ok;
+}
+
+/// @brief Counts one position and prints the result; returns false on a wrong count or a mismatch.
+bool run(const char* name, const Position& pos, int depth, uint64_t expected, int threads, bool divide, bool check) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint64_t> perMove;
+    bool ok = count(pos, depth, threads, check, perMove);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t nodes = 0;
+    for (uint64_t n : perMove)
+        nodes += n;
+    if (depth == 0)
+        nodes = 1;
+
+    if (divide) {
+        MoveList moves;
+        generateMoves(pos, moves);
+        for (int i = 0; i < moves.size(); ++i)
+            std::printf("  %-12s %llu\n", pdnMoveText(moves[i]).c_str(), static_cast<unsigned long long>(perMove[i]));
+    }
+
+    const char* verdict = !ok ? "MISMATCH" : (expected && nodes != expected) ? "WRONG" : expected ? "ok" : "";
+    std::printf("%-12s depth %2d  nodes %12llu  %8.3fs  %8.2f Mnps  %s%s\n", name, depth,
+                static_cast<unsigned long long>(nodes), seconds, seconds > 0 ? nodes / seconds / 1e6 : 0.0,
+                verdict, (ok && check) ? (*verdict ? ", rules agree" : "rules agree") : "");
+    if (ok && expected && nodes != expected)
+        std::printf("  expected %llu\n", static_cast<unsigned long long>(expected));
+    std::fflush(stdout);
+    return ok && (!expected || nodes == expected);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string fen;
+    int depth = -1;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    bool divide = false, check = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--fen" && i + 1 < argc) {
+            fen = argv[++i];
+        } else if (arg == "--depth" && i + 1 < argc) {
+            depth = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--divide") {
+            divide = true;
+        } else if (arg == "--verify") {
+            check = true;
+        } else {
+            std::fprintf(stderr, "usage: perft [--fen FEN] [--depth N] [--threads T] [--divide] [--verify]\n");
+            return 1;
+        }
+    }
+
+    if (!fen.empty()) {
+        Position pos;
+        if (!parsePdnFen(fen, pos)) {
+            std::fprintf(stderr, "perft: not a FEN: %s\n", fen.c_str());
+            return 1;
+        }
+        return run("position", pos, depth >= 0 ? depth : 6, 0, threads, divide, check) ? 0 : 1;
+    }
+
+    bool ok = true;
+    for (const SuitePosition& entry : SUITE) {
+        Position pos;
+        parsePdnFen(entry.fen, pos);
+        bool fixed = depth < 0;
+        ok = run(entry.name, pos, fixed ? entry.depth : depth, fixed ? entry.nodes : 0, threads, divide, check) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+# Move generator perft counter and rules cross-check: qmake tools/perft/perft.pro && make
+
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+TEMPLATE = app
+TARGET = perft
+
+LIBS += -pthread
+QMAKE_CXXFLAGS += -pthread
+
+include(../../engine.pri)
+
+SOURCES += \
+    perft.cpp
@@ -0,0 +1,307 @@
+/**
+ * @file tbgen.cpp
+ * @brief Offline generator for the endgame tablebases, using parallel retrograde analysis.
+ *
+ * Usage: tbgen [--pieces N] [--threads T] [--dtw] [--out DIR]
+ *
+ * Tables are built from the fewest pieces upwards. A table and its mirror
+ * (the same material with the other side to move) are solved together, since
+ * quiet moves lead from one to the other; every capture or promotion leads to
+ * a table that is already finished.
+ *
+ * Solving is done in passes. Pass k gives code k to every position decided in
+ * exactly k - 1 plies: a win if some move reaches a loss found earlier, a loss
+ * if every move reaches a win found earlier. Each pass reads the previous
+ * pass's array and writes a new one, so threads can split the indices into
+ * chunks with no locking. Whatever is still open once no later pass can change it
+ * is a draw.
+ *
+ * Finished tables are written to disk straight away and reloaded on the next
+ * run, so an interrupted generation resumes with the first missing table.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "MoveGen.h"
+#include "Tablebase.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const uint64_t CHUNK_SIZE = 4096;  // Indices a thread claims at a time
+
+/// @brief Orders signatures so they can key a std::map.
+struct SignatureLess {
+    bool operator()(const MaterialSignature& a, const MaterialSignature& b) const {
+        return std::memcmp(&a, &b, sizeof(MaterialSignature)) < 0;
+    }
+};
+
+using SolvedMap = std::map<MaterialSignature, std::vector<uint8_t>, SignatureLess>;
+
+/// @brief Tables being solved together in one group (a signature and its mirror).
+struct Group {
+    std::vector<MaterialSignature> sigs;          ///< One or two signatures
+    std::vector<std::vector<uint8_t>> current;    ///< Codes after the last pass
+    std::vector<std::vector<uint8_t>> next;       ///< Codes being written by this pass
+    uint64_t total = 0;                           ///< Indices over all tables
+    std::vector<bool> externalCodes;              ///< Codes that occur in finished tables
+};
+
+/// @brief Command-line options.
+struct Options {
+    int pieces = 4;
+    int threads = 1;
+    bool dtw = false;
+    std::string out = "tablebases";
+};
+
+/// @brief Returns the code of a child position, or 0 if it is not known before pass k.
+uint8_t childCode(const Position& child, const Group& group, const SolvedMap& solved, int pass) {
+    Position canonical = tbCanonical(child);
+    if (canonical.black == 0)
+        return TB_LOSS;  // Every piece of the side to move was captured
+
+    MaterialSignature sig = tbSignature(canonical);
+    uint64_t index = tbIndex(canonical, sig);
+
+    for (size_t t = 0; t < group.sigs.size(); ++t)
+        if (group.sigs[t] == sig)
+            return group.current[t][index];
+
+    // Finished tables count from the pass their code would have been found in
+    auto it = solved.find(sig);
+    if (it == solved.end())
+        return TB_DRAW;
+    uint8_t code = it->second[index];
+    return (code < pass) ? code : uint8_t(TB_DRAW);
+}
+
+/// @brief Decides one open position for pass k; returns its new code or 0 if still open.
+uint8_t solvePosition(const Position& pos, const Group& group, const SolvedMap& solved, int pass) {
+    MoveList moves;
+    generateMoves(pos, moves);
+
+    bool allWins = true;
+    for (const Move& move : moves) {
+        Position child = pos;
+        child.applyMove(move);
+
+        uint8_t code = childCode(child, group, solved, pass);
+        if (dtwIsLoss(code))
+            return static_cast<uint8_t>(std::min(pass, static_cast<int>(TB_MAX_DTW)));
+        if (!dtwIsWin(code))
+            allWins = false;
+    }
+
+    if (!allWins)
+        return TB_DRAW;
+    // Past the largest code, distances are capped but keep their parity
+    return static_cast<uint8_t>(std::min(pass, TB_MAX_DTW - 1));
+}
+
+/// @brief Runs fn(table, index) over every index of the group on all threads.
+template <typename Fn>
+void parallelFor(const Group& group, int threadCount, Fn fn) {
+    std::atomic<uint64_t> nextChunk{0};
+
+    auto worker = [&]() {
+        while (true) {
+            uint64_t first = nextChunk.fetch_add(CHUNK_SIZE);
+            if (first >= group.total)
+                return;
+            uint64_t last = std::min(first + CHUNK_SIZE, group.total);
+
+            // Map the flat range onto the group's tables
+            uint64_t offset = 0;
+            for (size_t t = 0; t < group.sigs.size(); ++t) {
+                uint64_t size = group.current[t].size();
+                uint64_t begin = std::max(first, offset);
+                uint64_t end = std::min(last, offset + size);
+                for (uint64_t i = begin; i < end; ++i)
+                    fn(t, i - offset);
+                offset += size;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threadCount; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread& t : workers)
+        t.join();
+}
+
+/// @brief Solves a group by repeated passes until nothing changes.
+void solveGroup(Group& group, const SolvedMap& solved, int threadCount) {
+    // Pass 1: invalid placements and positions with no legal move
+    parallelFor(group, threadCount, [&](size_t t, uint64_t i) {
+        Position pos;
+        if (!tbPosition(group.sigs[t], i, pos)) {
+            group.current[t][i] = TB_INVALID;
+            return;
+        }
+        group.current[t][i] = hasLegalMove(pos) ? TB_DRAW : TB_LOSS;
+    });
+
+    for (int pass = 2;; ++pass) {
+        group.next = group.current;
+        std::atomic<uint64_t> changed{0};
+
+        parallelFor(group, threadCount, [&](size_t t, uint64_t i) {
+            if (group.current[t][i] != TB_DRAW)
+                return;
+
+            Position pos;
+            tbPosition(group.sigs[t], i, pos);
+            uint8_t code = solvePosition(pos, group, solved, pass);
+            if (code != TB_DRAW) {
+                group.next[t][i] = code;
+                changed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        group.current.swap(group.next);
+        if (changed > 0)
+            continue;
+
+        // Nothing moved: skip ahead to the pass where the next finished-table code shows up
+        int code = pass;
+        while (code <= TB_MAX_DTW && !group.externalCodes[code])
+            ++code;
+        if (code > TB_MAX_DTW)
+            break;
+        pass = code;
+    }
+}
+
+/**
+ * @brief Counts wins, losses and draws of a table for the progress log.
+ *
+ * Counts what the file holds, so a loaded table prints the same line as when
+ * it was generated: only indices of legal placements (the file fills the
+ * others in to compress them), and codes as written (WDL unless dtw).
+ */
+void printSummary(const MaterialSignature& sig, const std::vector<uint8_t>& values, bool dtw, const char* how) {
+    uint64_t wins = 0, losses = 0, draws = 0;
+    uint8_t longest = 0;
+    Position pos;
+    for (uint64_t i = 0; i < values.size(); ++i) {
+        if (!tbPosition(sig, i, pos))
+            continue;
+        uint8_t code = dtw ? values[i] : dtwToWdl(values[i]);
+        if (dtwIsWin(code)) ++wins;
+        else if (dtwIsLoss(code)) ++losses;
+        else ++draws;
+        if (code != TB_DRAW)
+            longest = std::max(longest, code);
+    }
+
+    std::printf("%s  %-9s  win %llu  loss %llu  draw %llu", sig.fileName().c_str(), how,
+                static_cast<unsigned long long>(wins), static_cast<unsigned long long>(losses),
+                static_cast<unsigned long long>(draws));
+    if (dtw)
+        std::printf("  longest %d plies", std::max(0, longest - 1));
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--pieces" && hasValue) {
+            options.pieces = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--dtw") {
+            options.dtw = true;
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.pieces >= 2 && options.pieces <= TB_MAX_PIECES;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: tbgen [--pieces 2..%d] [--threads T] [--dtw] [--out DIR]\n", TB_MAX_PIECES);
+        return 1;
+    }
+    mkdir(options.out.c_str(), 0755);
+
+    SolvedMap solved;
+    std::vector<bool> externalCodes(TB_MAX_DTW + 1, false);
+    auto start = std::chrono::steady_clock::now();
+
+    for (const MaterialSignature& sig : tbSignatures(options.pieces)) {
+        if (solved.count(sig))
+            continue;  // Already solved as the mirror of an earlier signature
+
+        Group group;
+        group.sigs.push_back(sig);
+        if (sig.mirrored() != sig)
+            group.sigs.push_back(sig.mirrored());
+
+        // Resume: reuse tables a previous run already finished. WDL files only
+        // keep win/loss, so they cannot seed a DTW run.
+        bool loaded = true;
+        for (const MaterialSignature& s : group.sigs) {
+            std::vector<uint8_t> values;
+            bool fileDtw = false;
+            if (!tbReadFile(options.out + "/" + s.fileName(), s, values, fileDtw) || fileDtw != options.dtw) {
+                loaded = false;
+                break;
+            }
+            group.current.push_back(std::move(values));
+        }
+
+        if (!loaded) {
+            group.current.clear();
+            for (const MaterialSignature& s : group.sigs) {
+                group.current.emplace_back(s.size(), TB_DRAW);
+                group.total += s.size();
+            }
+            group.externalCodes = externalCodes;
+            solveGroup(group, solved, options.threads);
+
+            for (size_t t = 0; t < group.sigs.size(); ++t) {
+                std::string path = options.out + "/" + group.sigs[t].fileName();
+                if (!tbWriteFile(path, group.sigs[t], group.current[t], options.dtw)) {
+                    std::fprintf(stderr, "tbgen: cannot write %s\n", path.c_str());
+                    return 1;
+                }
+            }
+        }
+
+        for (size_t t = 0; t < group.sigs.size(); ++t) {
+            printSummary(group.sigs[t], group.current[t], options.dtw, loaded ? "loaded" : "generated");
+            for (uint8_t code : group.current[t])
+                if (code != TB_DRAW && code != TB_INVALID)
+                    externalCodes[code] = true;
+            solved[group.sigs[t]] = std::move(group.current[t]);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("done: %zu tables in %.1f s on %d threads\n", solved.size(), seconds, options.threads);
+    return 0;
+}
@@ -0,0 +1,15 @@
+# Offline endgame tablebase generator: qmake tools/tbgen/tbgen.pro && make
+
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+TEMPLATE = app
+TARGET = tbgen
+
+LIBS += -pthread
+QMAKE_CXXFLAGS += -pthread
+
+include(../../engine.pri)
+
+SOURCES += \
+    tbgen.cpp
@@ -0,0 +1,384 @@
+/**
+ * @file tuner.cpp
+ * @brief Fits the evaluation weights to the results of recorded games (Texel tuning).
+ *
+ * Usage: tuner [--threads T] [--epochs N] [--rate R] [--scale S] [--skip-plies P]
+ *              [--out FILE] games.pdn...
+ *
+ * Every game with a result is replayed, and each quiet position in it (the
+ * side to move has no capture, so the search would score it with the static
+ * evaluation) is kept with the game's result. The evaluation is a weighted sum
+ * of features, so sigmoid(K * eval) can be read as the expected result and
+ * compared with the actual one. K is fitted first with the compiled-in
+ * weights; the weights are then fitted by gradient descent (Adam) on the mean
+ * squared error over all positions, each thread summing the gradient over
+ * its share of the positions.
+ *
+ * Positions are kept packed in 16 bytes, with the mobility terms counted once
+ * when they are loaded, so ten million positions take 160 MB.
+ *
+ * The result is written in the format of EvalParams.h, ready to build with
+ * qmake "EVAL_PARAMS=/path/to/FILE". The weights are rounded to integers in
+ * the engine's units; --scale multiplies them first for finer steps, at the
+ * price of changing those units.
+ *
+ * @author Humzah Zahid Malik
+ */
+
+#include "Evaluation.h"
+#include "Pdn.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int MAN_WEIGHTS = 0;                        // First man square weight
+const int KING_WEIGHTS = MAN_WEIGHTS + NUM_SQUARES;  // First king square weight
+const int CAPTURE_WEIGHT = KING_WEIGHTS + NUM_SQUARES;
+const int TWO_MOVES_WEIGHT = CAPTURE_WEIGHT + 1;
+const int FOUR_MOVES_WEIGHT = TWO_MOVES_WEIGHT + 1;
+const int NUM_WEIGHTS = FOUR_MOVES_WEIGHT + 1;
+
+const size_t CHUNK_SIZE = 16384;  // Positions a thread claims at a time
+
+/**
+ * @struct PackedPosition
+ * @brief A training position and its game's result in 16 bytes.
+ */
+struct PackedPosition {
+    uint32_t red = 0;       ///< Red pieces
+    uint32_t black = 0;     ///< Black pieces
+    uint32_t kings = 0;     ///< Kings of either side
+    int8_t captures = 0;    ///< Red's minus Black's pieces that can capture
+    int8_t twoMoves = 0;    ///< Red's minus Black's pieces with two or more moves
+    int8_t fourMoves = 0;   ///< Red's minus Black's pieces with four moves
+    uint8_t redCredit = 0;  ///< 2 if Red won, 1 for a draw, 0 if Red lost
+};
+
+static_assert(sizeof(PackedPosition) == 16, "PackedPosition must stay 16 bytes");
+
+/// @brief Command-line options.
+struct Options {
+    int threads = 1;
+    int epochs = 1000;
+    double rate = 0.05;
+    int scale = 1;
+    int skipPlies = 8;
+    std::string out = "EvalParamsTuned.h";
+    std::vector<std::string> inputs;
+};
+
+/// @brief Weights as the tuner works on them.
+using Weights = std::vector<double>;
+
+/// @brief Returns the compiled-in weights.
+Weights initialWeights() {
+    Weights weights(NUM_WEIGHTS);
+    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
+        weights[MAN_WEIGHTS + sq] = EvalParams::MAN_SQUARE[sq];
+        weights[KING_WEIGHTS + sq] = EvalParams::KING_SQUARE[sq];
+    }
+    weights[CAPTURE_WEIGHT] = EvalParams::CAPTURE_THREAT;
+    weights[TWO_MOVES_WEIGHT] = EvalParams::MOBILITY_TWO;
+    weights[FOUR_MOVES_WEIGHT] = EvalParams::MOBILITY_FOUR;
+    return weights;
+}
+
+/// @brief Calls fn(index, weight) for every feature present in a position, as the
+///        engine would count it: Red pieces add, Black pieces (mirrored) subtract.
+template <typename Fn>
+void forEachFeature(const PackedPosition& pos, Fn fn) {
+    for (uint32_t pieces = pos.red; pieces; pieces &= pieces - 1) {
+        int sq = __builtin_ctz(pieces);
+        fn(((pos.kings & bit(sq)) ? KING_WEIGHTS : MAN_WEIGHTS) + sq, 1);
+    }
+    for (uint32_t pieces = pos.black; pieces; pieces &= pieces - 1) {
+        int sq = __builtin_ctz(pieces);
+        fn(((pos.kings & bit(sq)) ? KING_WEIGHTS : MAN_WEIGHTS) + NUM_SQUARES - 1 - sq, -1);
+    }
+    fn(CAPTURE_WEIGHT, pos.captures);
+    fn(TWO_MOVES_WEIGHT, pos.twoMoves);
+    fn(FOUR_MOVES_WEIGHT, pos.fourMoves);
+}
+
+/// @brief Evaluation of a position from Red's point of view.
+double evaluate(const PackedPosition& pos, const Weights& weights) {
+    double score = 0;
+    forEachFeature(pos, [&](int index, int count) { score += weights[index] * count; });
+    return score;
+}
+
+double sigmoid(double k, double score) {
+    return 1.0 / (1.0 + std::exp(-k * score));
+}
+
+/**
+ * @class Tuner
+ * @brief Holds the training positions and fits the weights to them.
+ */
+class Tuner {
+public:
+    Tuner(int threads, int skipPlies) : threadCount(threads), firstPly(skipPlies) {}
+
+    /// @brief Adds the quiet positions of every game in a PDN file.
+    bool addFile(const std::string& path) {
+        return readPdnFile(path, [this](const PdnGame& game) { addGame(game); });
+    }
+
+    size_t size() const { return positions.size(); }
+    int gamesUsed() const { return used; }
+
+    /// @brief Mean squared error of the predictions.
+    double error(double k, const Weights& weights) const {
+        std::vector<double> sums(threadCount, 0.0);
+        parallelFor([&](int thread, size_t begin, size_t end) {
+            double sum = 0;
+            for (size_t i = begin; i < end; ++i) {
+                double diff = target(positions[i]) - sigmoid(k, evaluate(positions[i], weights));
+                sum += diff * diff;
+            }
+            sums[thread] += sum;
+        });
+        double total = 0;
+        for (double sum : sums)
+            total += sum;
+        return total / positions.size();
+    }
+
+    /// @brief Finds the K with the least error by golden-section search.
+    double fitK(const Weights& weights) const {
+        const double ratio = (std::sqrt(5.0) - 1) / 2;
+        double low = 0.0, high = 5.0;
+        while (high - low > 1e-4) {
+            double a = high - ratio * (high - low);
+            double b = low + ratio * (high - low);
+            if (error(a, weights) < error(b, weights))
+                high = b;
+            else
+                low = a;
+        }
+        return (low + high) / 2;
+    }
+
+    /// @brief Fits the weights with Adam, printing the error every so often.
+    void fitWeights(double k, Weights& weights, int epochs, double rate) const {
+        const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+        Weights moment(NUM_WEIGHTS, 0.0), velocity(NUM_WEIGHTS, 0.0);
+
+        for (int epoch = 1; epoch <= epochs; ++epoch) {
+            Weights grad = gradient(k, weights);
+            for (int i = 0; i < NUM_WEIGHTS; ++i) {
+                moment[i] = beta1 * moment[i] + (1 - beta1) * grad[i];
+                velocity[i] = beta2 * velocity[i] + (1 - beta2) * grad[i] * grad[i];
+                double m = moment[i] / (1 - std::pow(beta1, epoch));
+                double v = velocity[i] / (1 - std::pow(beta2, epoch));
+                weights[i] -= rate * m / (std::sqrt(v) + epsilon);
+            }
+            if (epoch % 100 == 0 || epoch == epochs) {
+                std::printf("epoch %5d  error %.6f\n", epoch, error(k, weights));
+                std::fflush(stdout);
+            }
+        }
+    }
+
+private:
+    int threadCount;
+    int firstPly;
+    std::vector<PackedPosition> positions;
+    int used = 0;
+
+    /// @brief Packs the quiet positions of one game from ply firstPly on.
+    void addGame(const PdnGame& game) {
+        if (game.blackCredit < 0 || game.setUp || !game.complete)
+            return;
+
+        Position pos = Position::initial();
+        for (size_t ply = 0; ply <= game.moves.size(); ++ply) {
+            MoveList captures;
+            generateCaptures(pos, captures);
+            if (static_cast<int>(ply) >= firstPly && captures.empty())
+                positions.push_back(pack(pos, 2 - game.blackCredit));
+            if (ply < game.moves.size())
+                pos.applyMove(game.moves[ply]);
+        }
+        used++;
+    }
+
+    /// @brief Packs a position, counting its mobility terms.
+    static PackedPosition pack(const Position& pos, int redCredit) {
+        MobilityTerms red = mobilityTerms<Side::Red>(pos);
+        MobilityTerms black = mobilityTerms<Side::Black>(pos);
+
+        PackedPosition packed;
+        packed.red = pos.red;
+        packed.black = pos.black;
+        packed.kings = pos.kings;
+        packed.captures = static_cast<int8_t>(red.captures - black.captures);
+        packed.twoMoves = static_cast<int8_t>(red.twoMoves - black.twoMoves);
+        packed.fourMoves = static_cast<int8_t>(red.fourMoves - black.fourMoves);
+        packed.redCredit = static_cast<uint8_t>(redCredit);
+        return packed;
+    }
+
+    /// @brief The game's result for Red as 0, 0.5 or 1.
+    static double target(const PackedPosition& pos) {
+        return pos.redCredit / 2.0;
+    }
+
+    /// @brief Gradient of the mean squared error with respect to every weight.
+    Weights gradient(double k, const Weights& weights) const {
+        std::vector<Weights> sums(threadCount, Weights(NUM_WEIGHTS, 0.0));
+        parallelFor([&](int thread, size_t begin, size_t end) {
+            Weights& sum = sums[thread];
+            for (size_t i = begin; i < end; ++i) {
+                // d/dw (r - s)^2 = -2 (r - s) s (1 - s) k x
+                double s = sigmoid(k, evaluate(positions[i], weights));
+                double factor = -2 * (target(positions[i]) - s) * s * (1 - s) * k;
+                forEachFeature(positions[i], [&](int index, int count) { sum[index] += factor * count; });
+            }
+        });
+
+        Weights total(NUM_WEIGHTS, 0.0);
+        for (const Weights& sum : sums)
+            for (int i = 0; i < NUM_WEIGHTS; ++i)
+                total[i] += sum[i] / positions.size();
+        return total;
+    }
+
+    /// @brief Runs fn(thread, begin, end) over chunks of the positions on all threads.
+    template <typename Fn>
+    void parallelFor(Fn fn) const {
+        std::atomic<size_t> nextChunk{0};
+
+        auto worker = [&](int thread) {
+            while (true) {
+                size_t begin = nextChunk.fetch_add(CHUNK_SIZE);
+                if (begin >= positions.size())
+                    return;
+                fn(thread, begin, std::min(begin + CHUNK_SIZE, positions.size()));
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threadCount; ++i)
+            workers.emplace_back(worker, i);
+        worker(0);
+        for (std::thread& t : workers)
+            t.join();
+    }
+};
+
+/// @brief Writes one square table, four squares to a line.
+void writeTable(std::ofstream& out, const char* name, const Weights& weights, int first, int scale) {
+    out << "constexpr int " << name << "[32] = {\n";
+    for (int row = 0; row < 8; ++row) {
+        out << "   ";
+        for (int i = 0; i < 4; ++i) {
+            int sq = row * 4 + i;
+            out << ' ' << std::lround(weights[first + sq] * scale) << (sq < NUM_SQUARES - 1 ? "," : "");
+        }
+        out << '\n';
+    }
+    out << "};\n\n";
+}
+
+/// @brief Writes the weights in the format of EvalParams.h.
+bool writeParams(const std::string& path, const Weights& weights, int scale, size_t positions, double error) {
+    std::ofstream out(path);
+    if (!out)
+        return false;
+
+    out << "/**\n"
+        << " * @file " << path.substr(path.find_last_of("/\\") + 1) << "\n"
+        << " * @brief Evaluation weights fitted by the tuner tool.\n"
+        << " *\n"
+        << " * Fitted to " << positions << " positions, mean squared error " << error << ".\n"
+        << " * Build with qmake \"EVAL_PARAMS=/path/to/this/file\". See EvalParams.h.\n"
+        << " */\n\n"
+        << "#ifndef EVALPARAMS_H\n#define EVALPARAMS_H\n\n"
+        << "namespace EvalParams {\n\n";
+    writeTable(out, "MAN_SQUARE", weights, MAN_WEIGHTS, scale);
+    writeTable(out, "KING_SQUARE", weights, KING_WEIGHTS, scale);
+    out << "constexpr int CAPTURE_THREAT = " << std::lround(weights[CAPTURE_WEIGHT] * scale) << ";\n"
+        << "constexpr int MOBILITY_TWO = " << std::lround(weights[TWO_MOVES_WEIGHT] * scale) << ";\n"
+        << "constexpr int MOBILITY_FOUR = " << std::lround(weights[FOUR_MOVES_WEIGHT] * scale) << ";\n\n"
+        << "}\n\n#endif // EVALPARAMS_H\n";
+    return static_cast<bool>(out);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--threads" && hasValue) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--epochs" && hasValue) {
+            options.epochs = std::atoi(argv[++i]);
+        } else if (arg == "--rate" && hasValue) {
+            options.rate = std::atof(argv[++i]);
+        } else if (arg == "--scale" && hasValue) {
+            options.scale = std::atoi(argv[++i]);
+        } else if (arg == "--skip-plies" && hasValue) {
+            options.skipPlies = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    return options.epochs >= 0 && options.rate > 0 && options.scale >= 1 && !options.inputs.empty();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: tuner [--threads T] [--epochs N] [--rate R] [--scale S] [--skip-plies P]\n"
+                             "             [--out FILE] games.pdn...\n");
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    Tuner tuner(options.threads, options.skipPlies);
+    for (const std::string& path : options.inputs) {
+        if (!tuner.addFile(path)) {
+            std::fprintf(stderr, "tuner: cannot read %s\n", path.c_str());
+            return 1;
+        }
+    }
+    if (tuner.size() == 0) {
+        std::fprintf(stderr, "tuner: no positions with a known result\n");
+        return 1;
+    }
+    std::printf("%zu positions from %d games (%.1f MB)\n", tuner.size(), tuner.gamesUsed(),
+                tuner.size() * sizeof(PackedPosition) / 1048576.0);
+
+    Weights weights = initialWeights();
+    double k = tuner.fitK(weights);
+    std::printf("K = %.5f  error %.6f\n", k, tuner.error(k, weights));
+
+    tuner.fitWeights(k, weights, options.epochs, options.rate);
+    double error = tuner.error(k, weights);
+
+    if (!writeParams(options.out, weights, options.scale, tuner.size(), error)) {
+        std::fprintf(stderr, "tuner: cannot write %s\n", options.out.c_str());
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("weights written to %s in %.1f s on %d threads\n", options.out.c_str(), seconds, options.threads);
+    return 0;
+}
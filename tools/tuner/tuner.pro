@@ -0,0 +1,15 @@
+# Evaluation weight tuner: qmake tools/tuner/tuner.pro && make
+
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+TEMPLATE = app
+TARGET = tuner
+
+LIBS += -pthread
+QMAKE_CXXFLAGS += -pthread
+
+include(../../engine.pri)
+
+SOURCES += \
+    tuner.cpp